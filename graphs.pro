@@ -4,24 +4,56 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
 
+# Optimize more aggressively than the default (-O2), so that the inner loops of the algorithms are vectorized
+!msvc {
+    QMAKE_CXXFLAGS_RELEASE -= -O2
+    QMAKE_CXXFLAGS_RELEASE += -O3
+}
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    src/analysiscache.cpp \
+    src/benchmark.cpp \
+    src/dynamicshortestpaths.cpp \
     src/errorwidget.cpp \
+    src/forcelayout.cpp \
     src/graphwidget.cpp \
+    src/hardware.cpp \
     src/main.cpp \
     src/mainwindow.cpp \
+    src/mappedfile.cpp \
     src/matrice.cpp \
-    src/matricewidget.cpp
+    src/matriceparser.cpp \
+    src/matricewidget.cpp \
+    src/minplus.cpp \
+    src/primkernels.cpp \
+    src/threadpool.cpp
 
 HEADERS += \
+    src/analysiscache.h \
+    src/benchmark.h \
+    src/binaryformat.h \
+    src/celltype.h \
+    src/daryheap.h \
+    src/dynamicshortestpaths.h \
     src/errorwidget.h \
+    src/forcelayout.h \
     src/graphwidget.h \
+    src/hardware.h \
     src/mainwindow.h \
+    src/mappedfile.h \
     src/matrice.h \
-    src/matricewidget.h
+    src/matriceparser.h \
+    src/matricewidget.h \
+    src/minplus.h \
+    src/primkernels.h \
+    src/progress.h \
+    src/radixheap.h \
+    src/threadpool.h \
+    src/unionfind.h
 
 FORMS += \
     ui/mainwindow.ui
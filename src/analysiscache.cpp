@@ -0,0 +1,114 @@
+#include "analysiscache.h"
+
+/******************************
+| Constructors and Destructor |
+******************************/
+
+AnalysisCache::AnalysisCache(const Matrice* graph):
+    graph(graph)
+{}
+
+AnalysisCache::~AnalysisCache()
+{
+    reset(nullptr);
+}
+
+void AnalysisCache::reset(const Matrice* graph)
+{
+    // Free the results
+    delete distances;
+    delete nextHops;
+    delete spanningTree;
+    delete clusters;
+    distances = nullptr;
+    nextHops = nullptr;
+    spanningTree = nullptr;
+    clusters = nullptr;
+    components.clear();
+
+    this->graph = graph;
+}
+
+/**********************
+| Getters and Setters |
+**********************/
+
+const Matrice* AnalysisCache::getGraph() const
+{
+    return graph;
+}
+
+uint64_t AnalysisCache::getHits() const
+{
+    return hits;
+}
+
+uint64_t AnalysisCache::getMisses() const
+{
+    return misses;
+}
+
+/***********
+| Analyses |
+***********/
+
+const Matrice* AnalysisCache::shortestPaths(const Matrice** nextHops, Matrice::ShortestPathsEngine* engine, const ProgressHooks* hooks)
+{
+    if (distances != nullptr) {
+        hits++;
+    } else {
+        Matrice* newNextHops = nullptr;
+        distances = graph->shortestPaths(&newNextHops, &shortestPathsEngine, hooks);
+        this->nextHops = newNextHops;
+        misses++;
+    }
+
+    if (nextHops != nullptr) *nextHops = this->nextHops;
+    if (engine != nullptr) *engine = shortestPathsEngine;
+    return distances;
+}
+
+const Matrice* AnalysisCache::minimumSpanningTree(Matrice::SpanningTreeEngine* engine, const ProgressHooks* hooks)
+{
+    if (spanningTree != nullptr) {
+        hits++;
+    } else {
+        spanningTree = graph->minimumSpanningTree(&spanningTreeEngine, hooks);
+        misses++;
+    }
+
+    if (engine != nullptr) *engine = spanningTreeEngine;
+    return spanningTree;
+}
+
+const AnalysisCache::Clusters& AnalysisCache::stronglyConnectedComponents(const Matrice* matrice, Matrice::SccEngine* engine, const ProgressHooks* hooks)
+{
+    if (matrice == nullptr) matrice = graph;
+
+    auto found = components.find(matrice);
+    if (found != components.end()) {
+        hits++;
+    } else {
+        ClustersResult result;
+        result.clusters = matrice->stronglyConnectedComponents(&result.engine, hooks);
+        found = components.emplace(matrice, std::move(result)).first;
+        misses++;
+    }
+
+    if (engine != nullptr) *engine = found->second.engine;
+    return found->second.clusters;
+}
+
+const Matrice* AnalysisCache::clusterMatrice(Matrice::SccEngine* engine, const ProgressHooks* hooks)
+{
+    // The clusters are requested even on a hit, for the engine which found them
+    const Clusters& graphClusters = stronglyConnectedComponents(graph, engine, hooks);
+    if (clusters != nullptr) {
+        hits++;
+    } else {
+        clusters = graph->clusterMatrice(graphClusters, hooks);
+        misses++;
+    }
+
+    return clusters;
+}
@@ -0,0 +1,178 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include "matrice.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief The results of the analyses of a graph (shortest paths, minimum spanning tree, clusters and their graph), each computed
+ * the first time it is requested, then kept until the graph changes: switching between the views of a graph never computes them again.
+ * The cache owns the results it returns (they must not be deleted), but not the graph itself.
+ * Each request counts as a hit if its result was already computed, and as a miss otherwise.
+ * The hooks given to a request (see `ProgressHooks`) are only used if it is a miss; the result of a cancelled request is not kept.
+ */
+class AnalysisCache
+{
+
+public:
+    /**
+     * @brief The clusters (strongly connected components) of a graph, see `Matrice::stronglyConnectedComponents`.
+     */
+    using Clusters = std::vector<std::vector<uint32_t>>;
+
+    /******************************
+    | Constructors and Destructor |
+    ******************************/
+
+    /**
+     * @brief Construct a new, empty AnalysisCache object.
+     * @param graph The graph analysed (not owned, it must outlive the cache or be replaced with `reset`), or nullptr if there is none yet.
+     */
+    explicit AnalysisCache(const Matrice* graph = nullptr);
+
+    /**
+     * @brief Destroy the AnalysisCache object, and every result it holds.
+     */
+    ~AnalysisCache();
+
+    AnalysisCache(const AnalysisCache&) = delete;
+    AnalysisCache& operator=(const AnalysisCache&) = delete;
+
+    /**
+     * @brief Drop every result (the ones already returned are deleted), and analyse another graph.
+     * The hit and miss counters are kept.
+     * @param graph The new graph (not owned), or nullptr if there is none.
+     */
+    void reset(const Matrice* graph);
+
+    /**********************
+    | Getters and Setters |
+    **********************/
+
+    /**
+     * @brief Get the graph analysed.
+     * @return The graph, or nullptr if there is none.
+     */
+    const Matrice* getGraph() const;
+
+    /**
+     * @brief Get the number of requests answered with a result already computed.
+     * @return The number of hits.
+     */
+    uint64_t getHits() const;
+
+    /**
+     * @brief Get the number of requests which had to compute their result.
+     * @return The number of misses.
+     */
+    uint64_t getMisses() const;
+
+    /***********
+    | Analyses |
+    ***********/
+
+    /**
+     * @brief Get the shortest paths between all pairs of nodes of the graph, see `Matrice::shortestPaths`.
+     * The next hops are always computed with the distances, so that both views of the shortest paths share them.
+     * @param nextHops If not nullptr, receives the next hops of the shortest paths (owned by the cache).
+     * @param engine If not nullptr, receives the engine which computed them.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the computation.
+     * @return The shortest path distances (owned by the cache).
+     * @throws CancelledError if the computation is cancelled.
+     */
+    const Matrice* shortestPaths(const Matrice** nextHops = nullptr, Matrice::ShortestPathsEngine* engine = nullptr, const ProgressHooks* hooks = nullptr);
+
+    /**
+     * @brief Get the minimum spanning forest of the graph, see `Matrice::minimumSpanningTree`.
+     * @param engine If not nullptr, receives the engine which computed it.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the computation.
+     * @return The minimum spanning forest (owned by the cache).
+     * @throws CancelledError if the computation is cancelled.
+     */
+    const Matrice* minimumSpanningTree(Matrice::SpanningTreeEngine* engine = nullptr, const ProgressHooks* hooks = nullptr);
+
+    /**
+     * @brief Get the clusters (strongly connected components) of the graph, or of one of the results of the cache
+     * (ex. to lay out the minimum spanning tree), see `Matrice::stronglyConnectedComponents`.
+     * @param matrice The graph, or a result returned by this cache (nullptr for the graph).
+     * @param engine If not nullptr, receives the engine which found them.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the computation.
+     * @return The clusters (owned by the cache).
+     * @throws CancelledError if the computation is cancelled.
+     */
+    const Clusters& stronglyConnectedComponents(const Matrice* matrice = nullptr, Matrice::SccEngine* engine = nullptr, const ProgressHooks* hooks = nullptr);
+
+    /**
+     * @brief Get the graph of the clusters of the graph, see `Matrice::clusterMatrice`. Its clusters are the ones of
+     * `stronglyConnectedComponents`, which are requested too (and kept).
+     * @param engine If not nullptr, receives the engine which found the clusters.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the computation (of the clusters, then of their graph).
+     * @return The graph of the clusters (owned by the cache).
+     * @throws CancelledError if the computation is cancelled.
+     */
+    const Matrice* clusterMatrice(Matrice::SccEngine* engine = nullptr, const ProgressHooks* hooks = nullptr);
+
+private:
+    /**
+     * @brief The clusters of a matrice, and the engine which found them.
+     */
+    struct ClustersResult {
+        Clusters clusters;
+        Matrice::SccEngine engine;
+    };
+
+    /**
+     * @brief The graph analysed (not owned), or nullptr if there is none.
+     */
+    const Matrice* graph;
+
+    /**
+     * @brief The shortest path distances, or nullptr if they are not computed yet.
+     */
+    const Matrice* distances = nullptr;
+
+    /**
+     * @brief The next hops of the shortest paths, or nullptr if they are not computed yet.
+     */
+    const Matrice* nextHops = nullptr;
+
+    /**
+     * @brief The engine which computed the shortest paths (only meaningful once they are computed).
+     */
+    Matrice::ShortestPathsEngine shortestPathsEngine = Matrice::ShortestPathsEngine::FloydWarshall;
+
+    /**
+     * @brief The minimum spanning forest, or nullptr if it is not computed yet.
+     */
+    const Matrice* spanningTree = nullptr;
+
+    /**
+     * @brief The engine which computed the minimum spanning forest (only meaningful once it is computed).
+     */
+    Matrice::SpanningTreeEngine spanningTreeEngine = Matrice::SpanningTreeEngine::Prim;
+
+    /**
+     * @brief The graph of the clusters, or nullptr if it is not computed yet.
+     */
+    const Matrice* clusters = nullptr;
+
+    /**
+     * @brief The clusters found for the graph and the results, by matrice.
+     */
+    std::unordered_map<const Matrice*, ClustersResult> components;
+
+    /**
+     * @brief The number of requests answered with a result already computed.
+     */
+    uint64_t hits = 0;
+
+    /**
+     * @brief The number of requests which had to compute their result.
+     */
+    uint64_t misses = 0;
+};
+
+#endif // ANALYSISCACHE_H
@@ -0,0 +1,540 @@
+#include "benchmark.h"
+
+#include "dynamicshortestpaths.h"
+#include "hardware.h"
+#include "matrice.h"
+#include "minplus.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**********
+| Helpers |
+**********/
+
+namespace {
+
+/**
+ * @brief Measure the duration of a function call.
+ * @return The duration, in seconds.
+ */
+template<typename Function>
+double measure(Function&& function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Check whether two matrices have the same values.
+ */
+bool identical(const Matrice& a, const Matrice& b)
+{
+    if (a.getSize() != b.getSize()) return false;
+    for (uint32_t i = 0; i < a.getSize(); i++) {
+        for (uint32_t j = 0; j < a.getSize(); j++) {
+            if (a.getEdge(i, j) != b.getEdge(i, j)) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the thread counts to measure: the powers of two below the maximum, and the maximum.
+ */
+std::vector<uint32_t> threadCounts(uint32_t maxThreads)
+{
+    std::vector<uint32_t> counts;
+    for (uint32_t threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+/**
+ * @brief Benchmark the scaling of Floyd-Warshall with the number of threads.
+ */
+int benchmarkFloydWarshall(const Matrice& matrice, uint32_t maxThreads)
+{
+    std::printf("Floyd-Warshall on %u nodes\n", matrice.getSize());
+    std::printf("%8s %12s %8s %11s %10s\n", "threads", "time (s)", "speedup", "efficiency", "identical");
+    Matrice* reference = nullptr;
+    double referenceTime = 0;
+    bool allIdentical = true;
+    for (uint32_t threads : threadCounts(maxThreads)) {
+        Matrice* result = nullptr;
+        double time = measure([&] { result = matrice.floydWarshall(0, threads); });
+        if (reference == nullptr) {
+            reference = result;
+            referenceTime = time;
+        }
+        bool same = result == reference || identical(*result, *reference);
+        allIdentical = allIdentical && same;
+        std::printf("%8u %12.3f %7.2fx %10.0f%% %10s\n", threads, time, referenceTime / time,
+                    100 * referenceTime / time / threads, same ? "yes" : "NO");
+        if (result != reference) delete result;
+    }
+    delete reference;
+    return allIdentical ? 0 : 1;
+}
+
+/**
+ * @brief Benchmark the shortest paths engines against each other, and show the one chosen automatically.
+ */
+int benchmarkShortestPaths(const Matrice& matrice)
+{
+    const char* chosen = Matrice::shortestPathsEngineName(matrice.shortestPathsEngine());
+    std::printf("Shortest paths on %u nodes (automatic engine: %s)\n", matrice.getSize(), chosen);
+    std::printf("%16s %12s %10s\n", "engine", "time (s)", "identical");
+    Matrice* reference = nullptr;
+    double time = measure([&] { reference = matrice.floydWarshall(); });
+    std::printf("%16s %12.3f %10s\n", Matrice::shortestPathsEngineName(Matrice::ShortestPathsEngine::FloydWarshall), time, "yes");
+
+    bool same = true;
+    try {
+        Matrice* result = nullptr;
+        time = measure([&] { result = matrice.johnson(); });
+        same = identical(*result, *reference);
+        std::printf("%16s %12.3f %10s\n", Matrice::shortestPathsEngineName(Matrice::ShortestPathsEngine::Johnson), time, same ? "yes" : "NO");
+        delete result;
+    } catch (const std::runtime_error& e) {
+        std::printf("%16s %s\n", Matrice::shortestPathsEngineName(Matrice::ShortestPathsEngine::Johnson), e.what());
+    }
+    delete reference;
+    return same ? 0 : 1;
+}
+
+/**
+ * @brief Benchmark the spanning tree engines against each other, and the scaling of Borůvka's algorithm with the number of threads,
+ * checking that every result has the same total weight as Prim's algorithm.
+ */
+int benchmarkSpanningTree(const Matrice& matrice, uint32_t maxThreads)
+{
+    const char* chosen = Matrice::spanningTreeEngineName(matrice.spanningTreeEngine());
+    std::printf("Minimum spanning tree on %u nodes (automatic engine: %s)\n", matrice.getSize(), chosen);
+    std::printf("%16s %8s %12s %8s %14s\n", "engine", "threads", "time (s)", "speedup", "same weight");
+    Matrice* reference = nullptr;
+    double referenceTime = measure([&] { reference = matrice.prim(); });
+    const int64_t weight = reference->getTotalWeight();
+    std::printf("%16s %8u %12.3f %7.2fx %14s\n", Matrice::spanningTreeEngineName(Matrice::SpanningTreeEngine::Prim), 1u, referenceTime, 1.0, "yes");
+    delete reference;
+
+    bool allSame = true;
+    auto run = [&](Matrice::SpanningTreeEngine engine, uint32_t threads, auto compute) {
+        Matrice* result = nullptr;
+        double time = measure([&] { result = compute(); });
+        bool same = result->getTotalWeight() == weight;
+        allSame = allSame && same;
+        std::printf("%16s %8u %12.3f %7.2fx %14s\n", Matrice::spanningTreeEngineName(engine), threads, time, referenceTime / time, same ? "yes" : "NO");
+        delete result;
+    };
+    run(Matrice::SpanningTreeEngine::HeapPrim, 1, [&] { return matrice.heapPrim(); });
+    run(Matrice::SpanningTreeEngine::Kruskal, 1, [&] { return matrice.kruskal(); });
+    for (uint32_t threads : threadCounts(maxThreads)) {
+        run(Matrice::SpanningTreeEngine::Boruvka, threads, [&] { return matrice.boruvka(threads); });
+    }
+    return allSame ? 0 : 1;
+}
+
+/**
+ * @brief Benchmark Tarjan's algorithm against the forward-backward algorithm with each number of threads,
+ * checking that they find the same clusters.
+ */
+int benchmarkScc(const Matrice& matrice, uint32_t maxThreads)
+{
+    const uint32_t size = matrice.getSize();
+    const char* chosen = Matrice::sccEngineName(matrice.sccEngine());
+    std::printf("Strongly connected components on %u nodes (automatic engine: %s)\n", size, chosen);
+    std::printf("%16s %8s %12s %8s %10s %14s\n", "engine", "threads", "time (s)", "speedup", "clusters", "same clusters");
+
+    // Identify the cluster of each node by its first node, which is the same for both engines if they find the same clusters
+    std::vector<uint32_t> firstNode(size);
+    auto check = [&](const std::vector<std::vector<uint32_t>>& clusters, bool reference) {
+        bool same = true;
+        for (const std::vector<uint32_t>& cluster : clusters) {
+            for (uint32_t node : cluster) {
+                if (reference) firstNode[node] = cluster[0];
+                same = same && firstNode[node] == cluster[0];
+            }
+        }
+        return same;
+    };
+    std::vector<std::vector<uint32_t>> reference;
+    double referenceTime = measure([&] { reference = matrice.tarjan(); });
+    check(reference, true);
+    std::printf("%16s %8u %12.3f %7.2fx %10zu %14s\n", Matrice::sccEngineName(Matrice::SccEngine::Tarjan), 1u, referenceTime, 1.0,
+                reference.size(), "yes");
+
+    bool allSame = true;
+    for (uint32_t threads : threadCounts(maxThreads)) {
+        std::vector<std::vector<uint32_t>> clusters;
+        double time = measure([&] { clusters = matrice.forwardBackward(threads); });
+        bool same = clusters.size() == reference.size() && check(clusters, false);
+        allSame = allSame && same;
+        std::printf("%16s %8u %12.3f %7.2fx %10zu %14s\n", Matrice::sccEngineName(Matrice::SccEngine::ForwardBackward), threads, time,
+                    referenceTime / time, clusters.size(), same ? "yes" : "NO");
+    }
+    return allSame ? 0 : 1;
+}
+
+/**
+ * @brief Benchmark an algorithm without hooks, then with a progress callback and a cancellation token (never raised),
+ * checking that both give the same result, then measure how long it takes to stop once cancelled at half of its work.
+ * @param name The name of the algorithm.
+ * @param run Runs the algorithm with the given hooks (or nullptr).
+ * @param same Checks whether two results are the same.
+ * @param release Frees a result.
+ * @return Whether both results are the same, and the cancelled run threw `CancelledError`.
+ */
+template<typename Run, typename Same, typename Release>
+bool benchmarkHooks(const char* name, Run run, Same same, Release release)
+{
+    decltype(run(nullptr)) reference{};
+    double referenceTime = measure([&] { reference = run(nullptr); });
+
+    // The token is checked at each step, but never raised
+    CancellationToken token;
+    uint64_t calls = 0;
+    ProgressHooks hooks;
+    hooks.progress = [&](uint64_t, uint64_t) { calls++; };
+    hooks.cancellation = &token;
+    decltype(run(nullptr)) result{};
+    double time = measure([&] { result = run(&hooks); });
+    bool identical = same(reference, result);
+    release(reference);
+    release(result);
+
+    // Raise the token once half of the work is done, and measure the time until the algorithm stops
+    std::chrono::steady_clock::time_point cancelTime;
+    hooks.progress = [&](uint64_t done, uint64_t total) {
+        if (done * 2 >= total && !token.isCancelled()) {
+            cancelTime = std::chrono::steady_clock::now();
+            token.cancel();
+        }
+    };
+    bool cancelled = false;
+    try {
+        result = run(&hooks);
+        release(result);
+    } catch (const CancelledError&) {
+        cancelled = true;
+    }
+    double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - cancelTime).count();
+
+    std::printf("%16s %12.3f %12.3f %+9.1f%% %10llu %10s %12.3f\n", name, referenceTime, time, 100 * (time / referenceTime - 1),
+                static_cast<unsigned long long>(calls), identical ? "yes" : "NO", cancelled ? 1000 * latency : -1.0);
+    return identical && cancelled;
+}
+
+/**
+ * @brief Benchmark the cost of the progress and cancellation hooks of the long algorithms, and how fast they stop once cancelled.
+ */
+int benchmarkProgress(const Matrice& matrice)
+{
+    std::printf("Progress hooks on %u nodes (cancel latency: -1 if the algorithm ended before being cancelled)\n", matrice.getSize());
+    std::printf("%16s %12s %12s %10s %10s %10s %12s\n", "algorithm", "time (s)", "hooked (s)", "overhead", "callbacks", "identical",
+                "cancel (ms)");
+    auto sameMatrice = [](const Matrice* a, const Matrice* b) { return identical(*a, *b); };
+    auto deleteMatrice = [](Matrice* matrice) { delete matrice; };
+    auto sameClusters = [](const std::vector<std::vector<uint32_t>>& a, const std::vector<std::vector<uint32_t>>& b) { return a == b; };
+    auto keepClusters = [](std::vector<std::vector<uint32_t>>&) {};
+
+    bool allGood = true;
+    allGood &= benchmarkHooks("floyd-warshall", [&](const ProgressHooks* hooks) {
+        return matrice.floydWarshall(0, 0, nullptr, hooks);
+    }, sameMatrice, deleteMatrice);
+    allGood &= benchmarkHooks("prim", [&](const ProgressHooks* hooks) {
+        return matrice.prim(simdLevel(), hooks);
+    }, sameMatrice, deleteMatrice);
+    allGood &= benchmarkHooks("tarjan", [&](const ProgressHooks* hooks) {
+        return matrice.tarjan(hooks);
+    }, sameClusters, keepClusters);
+    allGood &= benchmarkHooks("clusters", [&](const ProgressHooks* hooks) {
+        return matrice.clusterMatrice(nullptr, hooks);
+    }, sameMatrice, deleteMatrice);
+    return allGood ? 0 : 1;
+}
+
+/**
+ * @brief Benchmark the incremental shortest paths against a full recomputation, on batches of random weight changes,
+ * and check that both give the same distances.
+ */
+int benchmarkDynamicPaths(const Matrice& matrice, uint32_t batchSize)
+{
+    const uint32_t size = matrice.getSize();
+    const uint32_t batches = 10;
+    if (size == 0) return 0;
+    DynamicShortestPaths* paths = nullptr;
+    double seedTime = measure([&] { paths = new DynamicShortestPaths(matrice); });
+    std::printf("Seeded the shortest paths of %u nodes in %.3f s\n", size, seedTime);
+    std::printf("%6s %9s %14s %16s %10s\n", "batch", "changes", "update (ms)", "recompute (ms)", "identical");
+
+    // Change random cells: remove, increase or decrease existing edges, or add new ones (weights stay in the range of the graph)
+    int64_t maxWeight = 1;
+    for (uint32_t i = 0; i < size; i++) {
+        for (uint32_t j = 0; j < size; j++) {
+            if (paths->getWeight(i, j) > maxWeight) maxWeight = paths->getWeight(i, j);
+        }
+    }
+    std::mt19937_64 random(42);
+    int32_t** weights = new int32_t*[size];
+    for (uint32_t i = 0; i < size; i++) weights[i] = new int32_t[size];
+    bool allIdentical = true;
+    for (uint32_t batch = 1; batch <= batches; batch++) {
+        std::vector<DynamicShortestPaths::EdgeUpdate> updates;
+        for (uint32_t k = 0; k < batchSize; k++) {
+            uint32_t from = random() % size;
+            uint32_t to = random() % size;
+            int64_t weight = random() % 8 == 0 ? 0 : 1 + static_cast<int64_t>(random() % maxWeight);
+            updates.push_back({from, to, weight});
+        }
+        std::vector<DynamicShortestPaths::CellChange> changes;
+        double updateTime = measure([&] {
+            try {
+                changes = paths->update(updates);
+            } catch (const std::runtime_error&) {
+                // A negative cycle: the following updates of the batch are ignored
+            }
+        });
+
+        // Recompute the paths of the changed graph from scratch
+        for (uint32_t i = 0; i < size; i++) {
+            for (uint32_t j = 0; j < size; j++) weights[i][j] = static_cast<int32_t>(paths->getWeight(i, j));
+        }
+        Matrice graph(size, weights);
+        Matrice* reference = nullptr;
+        double recomputeTime = measure([&] { reference = graph.floydWarshall(); });
+        bool same = true;
+        for (uint32_t i = 0; i < size && same; i++) {
+            for (uint32_t j = 0; j < size && same; j++) same = paths->getDistance(i, j) == reference->getEdge(i, j);
+        }
+        allIdentical = allIdentical && same;
+        delete reference;
+        std::printf("%6u %9zu %14.3f %16.3f %10s\n", batch, changes.size(), 1000 * updateTime, 1000 * recomputeTime, same ? "yes" : "NO");
+    }
+
+    for (uint32_t i = 0; i < size; i++) delete[] weights[i];
+    delete[] weights;
+    delete paths;
+    return allIdentical ? 0 : 1;
+}
+
+/**
+ * @brief Prim's algorithm as first written (one branch per cell, reading the row and then the column of each node added,
+ * and scanning the nodes not in the tree for the closest one), used as the reference.
+ * @return The parent of each node in the spanning forest (UINT32_MAX for the roots).
+ */
+std::vector<uint32_t> primBranchy(const Matrice& matrice)
+{
+    const uint32_t size = matrice.getSize();
+    std::vector<bool> inMST(size, false);
+    std::vector<int64_t> distance(size, INT64_MAX);
+    std::vector<uint32_t> parent(size, UINT32_MAX);
+    uint32_t nextRoot = 0;
+    for (uint32_t _ = 0; _ < size; _++) {
+        uint32_t to = UINT32_MAX;
+        int64_t minEdge = INT64_MAX;
+        for (uint32_t j = 0; j < size; j++) {
+            if (!inMST[j] && distance[j] < minEdge) {
+                minEdge = distance[j];
+                to = j;
+            }
+        }
+        if (to == UINT32_MAX) {
+            while (inMST[nextRoot]) nextRoot++;
+            to = nextRoot;
+        }
+        inMST[to] = true;
+
+        auto update = [&](uint32_t other, int64_t weight) {
+            if (weight != 0 && weight != INT64_MAX && !inMST[other] && weight < distance[other]) {
+                distance[other] = weight;
+                parent[other] = to;
+            }
+        };
+        for (uint32_t j = 0; j < size; j++) update(j, matrice.getEdge(to, j));
+        for (uint32_t j = 0; j < size; j++) update(j, matrice.getEdge(j, to));
+    }
+    return parent;
+}
+
+/**
+ * @brief Benchmark Prim's algorithm with each SIMD level supported by the processor, against the branchy version,
+ * and check that they all give its tree.
+ */
+int benchmarkPrim(const Matrice& matrice)
+{
+    std::printf("Prim's algorithm on %u nodes (%s, %s)\n", matrice.getSize(), matrice.getLayout() == Matrice::Layout::Dense ? "dense" : "not dense",
+                matrice.isOriented() ? "oriented" : "not oriented");
+    std::printf("%9s %12s %9s %10s\n", "kernel", "time (s)", "speedup", "identical");
+    std::vector<uint32_t> reference;
+    double referenceTime = measure([&] { reference = primBranchy(matrice); });
+    std::printf("%9s %12.3f %8.2fx %10s\n", "branchy", referenceTime, 1.0, "yes");
+
+    // The same tree has the same number of edges (one per node with a parent), and contains every edge of the reference
+    uint64_t referenceEdges = 0;
+    for (uint32_t node = 0; node < matrice.getSize(); node++) referenceEdges += reference[node] != UINT32_MAX;
+    bool allIdentical = true;
+    for (uint8_t level = 0; level <= static_cast<uint8_t>(simdLevel()); level++) {
+        Matrice* result = nullptr;
+        double time = measure([&] { result = matrice.prim(static_cast<SimdLevel>(level)); });
+        uint64_t edges = 0;
+        bool same = true;
+        for (uint32_t node = 0; node < matrice.getSize(); node++) {
+            if (reference[node] == UINT32_MAX) continue;
+            same = same && result->getEdge(node, reference[node]) != 0;
+        }
+        for (uint32_t node = 0; node < matrice.getSize() && same; node++) {
+            for (uint32_t other = node + 1; other < matrice.getSize(); other++) edges += result->getEdge(node, other) != 0;
+        }
+        same = same && edges == referenceEdges;
+        allIdentical = allIdentical && same;
+        std::printf("%9s %12.3f %8.2fx %10s\n", simdLevelName(static_cast<SimdLevel>(level)), time, referenceTime / time, same ? "yes" : "NO");
+        delete result;
+    }
+    return allIdentical ? 0 : 1;
+}
+
+/**
+ * @brief The min-plus loop as first written (one branch per cell, and a conditional store), used as the reference.
+ */
+template<typename T>
+void minPlusBranchy(T* rowI, const T* rowK, T pathIK, uint32_t count)
+{
+    const T infinity = std::numeric_limits<T>::max();
+    for (uint32_t j = 0; j < count; j++) {
+        if (rowK[j] == infinity) continue;
+        T length = pathIK + rowK[j];
+        if (length < rowI[j]) rowI[j] = length;
+    }
+}
+
+/**
+ * @brief Benchmark every min-plus kernel supported by the processor on rows of one cell type,
+ * against the branchy loop, and check that they all give its result.
+ */
+template<typename T>
+bool benchmarkMinPlusType(const char* typeName, uint32_t length)
+{
+    // Random rows with negative weights and about 10% of infinite cells, whose finite sums fit in the type
+    const T infinity = std::numeric_limits<T>::max();
+    const T bound = std::numeric_limits<T>::max() / 4;
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<int64_t> weight(-bound, bound);
+    auto randomRow = [&] {
+        std::vector<T> row(length);
+        for (T& cell : row) cell = random() % 10 == 0 ? infinity : static_cast<T>(weight(random));
+        return row;
+    };
+    const std::vector<T> rowI = randomRow();
+    const std::vector<T> rowK = randomRow();
+    const T pathIK = static_cast<T>(weight(random));
+
+    // Relax enough cells for each kernel to take a measurable time
+    const uint64_t repeats = std::max<uint64_t>(1, (uint64_t(1) << 28) / std::max(1u, length));
+    auto run = [&](MinPlusKernel<T> kernel, std::vector<T>& result) {
+        result = rowI;
+        kernel(result.data(), rowK.data(), pathIK, length);  // Checked result (the next calls do not change it anymore)
+        return measure([&] {
+            for (uint64_t repeat = 0; repeat < repeats; repeat++) kernel(result.data(), rowK.data(), pathIK, length);
+        }) / (static_cast<double>(repeats) * length);
+    };
+
+    std::vector<T> reference;
+    double referenceTime = run(&minPlusBranchy<T>, reference);
+    std::printf("%6s %9s %12.3f %8.2fx %10s\n", typeName, "branchy", referenceTime * 1e9, 1.0, "yes");
+
+    bool allIdentical = true;
+    for (uint8_t level = 0; level <= static_cast<uint8_t>(simdLevel()); level++) {
+        std::vector<T> result;
+        double time = run(minPlusKernel<T>(static_cast<SimdLevel>(level)), result);
+        bool same = result == reference;
+        allIdentical = allIdentical && same;
+        std::printf("%6s %9s %12.3f %8.2fx %10s\n", typeName, simdLevelName(static_cast<SimdLevel>(level)),
+                    time * 1e9, referenceTime / time, same ? "yes" : "NO");
+    }
+    return allIdentical;
+}
+
+/**
+ * @brief Benchmark the min-plus kernels (inner loop of Floyd-Warshall) of every cell type, on rows of the given length.
+ */
+int benchmarkMinPlus(uint32_t length)
+{
+    std::printf("Min-plus kernels on rows of %u cells (newest SIMD level: %s)\n", length, simdLevelName(simdLevel()));
+    std::printf("%6s %9s %12s %9s %10s\n", "type", "kernel", "ns / cell", "speedup", "identical");
+    bool allIdentical = benchmarkMinPlusType<int8_t>("int8", length);
+    allIdentical = benchmarkMinPlusType<int16_t>("int16", length) && allIdentical;
+    allIdentical = benchmarkMinPlusType<int32_t>("int32", length) && allIdentical;
+    allIdentical = benchmarkMinPlusType<int64_t>("int64", length) && allIdentical;
+    return allIdentical ? 0 : 1;
+}
+
+}
+
+/************
+| Benchmark |
+************/
+
+int runBenchmark(int argc, char* argv[])
+{
+    std::string name = argc > 2 ? argv[2] : "";
+    if (name != "min-plus" && argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " --benchmark floyd-warshall <matrice file> [max threads]\n"
+                  << "       " << argv[0] << " --benchmark shortest-paths <matrice file>\n"
+                  << "       " << argv[0] << " --benchmark dynamic-paths <matrice file> [updates per batch]\n"
+                  << "       " << argv[0] << " --benchmark spanning-tree <matrice file> [max threads]\n"
+                  << "       " << argv[0] << " --benchmark prim <matrice file>\n"
+                  << "       " << argv[0] << " --benchmark scc <matrice file> [max threads]\n"
+                  << "       " << argv[0] << " --benchmark progress <matrice file>\n"
+                  << "       " << argv[0] << " --benchmark min-plus [row length]" << std::endl;
+        return 2;
+    }
+    try {
+        // The micro-benchmark does not need a matrix
+        if (name == "min-plus") {
+            return benchmarkMinPlus(argc > 3 ? std::stoul(argv[3]) : 4099);
+        }
+
+        Matrice* matrice = nullptr;
+        double loadTime = measure([&] { matrice = new Matrice(argv[3]); });
+        std::printf("Loaded %u nodes in %.3f s\n", matrice->getSize(), loadTime);
+
+        int result = 2;
+        if (name == "floyd-warshall") {
+            uint32_t maxThreads = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+            result = benchmarkFloydWarshall(*matrice, maxThreads);
+        } else if (name == "shortest-paths") {
+            result = benchmarkShortestPaths(*matrice);
+        } else if (name == "dynamic-paths") {
+            result = benchmarkDynamicPaths(*matrice, argc > 4 ? std::stoul(argv[4]) : 1);
+        } else if (name == "spanning-tree") {
+            uint32_t maxThreads = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+            result = benchmarkSpanningTree(*matrice, maxThreads);
+        } else if (name == "prim") {
+            result = benchmarkPrim(*matrice);
+        } else if (name == "scc") {
+            uint32_t maxThreads = argc > 4 ? std::stoul(argv[4]) : std::max(1u, std::thread::hardware_concurrency());
+            result = benchmarkScc(*matrice, maxThreads);
+        } else if (name == "progress") {
+            result = benchmarkProgress(*matrice);
+        } else {
+            std::cerr << "Unknown benchmark: " << name << std::endl;
+        }
+        delete matrice;
+        return result;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
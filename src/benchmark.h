@@ -0,0 +1,27 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/**
+ * @brief Run a benchmark from the command line, printing its results on the standard output.
+ * Usage: `graphs --benchmark <name> <matrice file> [arguments...]`, with the following benchmarks:
+ * - `floyd-warshall [max threads]`: time `Matrice::floydWarshall` with 1, 2, 4, ... threads, up to the given maximum
+ *   (every hardware thread by default), and check that every result is identical to the single-threaded one.
+ * - `shortest-paths`: time Floyd-Warshall and Johnson's algorithm, check that they give the same result, and show the automatic choice.
+ * - `dynamic-paths [updates per batch]`: time `DynamicShortestPaths` on batches of random weight changes (1 per batch by default),
+ *   against a full recomputation, and check that they give the same distances.
+ * - `spanning-tree [max threads]`: time each spanning tree engine, Borůvka's algorithm with 1, 2, 4, ... threads up to the given maximum,
+ *   check that every result has the same total weight as Prim's algorithm, and show the automatic choice.
+ * - `prim`: time Prim's algorithm with each SIMD level supported by the processor, against a branchy version reading each cell
+ *   of the row and the column of every node, and check that they give the same tree.
+ * - `scc [max threads]`: time Tarjan's algorithm, and the forward-backward algorithm with 1, 2, 4, ... threads up to the given maximum,
+ *   check that they find the same clusters, and show the automatic choice.
+ * - `progress`: time Floyd-Warshall, Prim's algorithm, Tarjan's algorithm and the graph of the clusters without hooks and with
+ *   a progress callback and a cancellation token, check that they give the same result, and measure how fast they stop once cancelled.
+ * - `min-plus [row length]` (without matrice file): time each min-plus kernel, and check that they give the same result.
+ * @param argc The number of arguments of the application.
+ * @param argv The arguments of the application (the first one being `--benchmark`).
+ * @return The exit code of the application.
+ */
+int runBenchmark(int argc, char* argv[]);
+
+#endif // BENCHMARK_H
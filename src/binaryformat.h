@@ -0,0 +1,42 @@
+#ifndef BINARYFORMAT_H
+#define BINARYFORMAT_H
+
+#include <cstdint>
+
+#define BINARY_MAGIC "GRAPHMAT"   // First 8 bytes of every binary matrix file (text files start with a digit)
+#define BINARY_VERSION 1          // Incremented at each incompatible change of the format
+#define BINARY_EXTENSION ".gbin"  // Extension of binary matrix files (only used by file dialogs, files are recognized by their magic)
+
+/**
+ * @brief The header of a binary matrix file, written as is at the start of the file.
+ *
+ * The header is followed by the sections holding the cells, each one starting on a cache line (relative to the start
+ * of the file, which is mapped on a page boundary), in the same layout as in memory so that they can be used in place:
+ * - Dense: `size` rows of `stride` cells of `type` ;
+ * - Bits: `size` rows of `stride` 64-bit words ;
+ * - Sparse: the offsets, columns and weights of the rows, then those of the transposed rows (see `SparseRows`).
+ * The names of the nodes (if any) come last, each one as its length (uint32_t) followed by its characters.
+ * Every value is stored in the byte order of the machine that wrote the file (little-endian on all supported platforms).
+ * Opening a file checks everything the walks of the cells rely on (the header, the bounds of the sections, the rows of the Sparse
+ * layout and the padding bits of the Bits layout), but not the `oriented` and `weighted` flags against the cells, which would read
+ * all of them: files are trusted to hold the flags of their cells, and wrong flags only give wrong results.
+ */
+struct BinaryHeader {
+    char magic[8];         // BINARY_MAGIC (without its terminating null character)
+    uint32_t version;      // BINARY_VERSION
+    uint32_t size;         // The number of nodes
+    uint32_t stride;       // The stride of the rows (Dense and Bits layouts, 0 otherwise)
+    uint8_t layout;        // The layout of the cells (`Matrice::Layout`)
+    uint8_t type;          // The type of the cells (`CellType`)
+    uint8_t oriented;      // Whether the graph is oriented (0 or 1, 255 if not computed)
+    uint8_t weighted;      // Whether the graph is weighted (0 or 1, 255 if not computed)
+    uint64_t cells;        // The number of stored cells (Sparse layout, 0 otherwise)
+    uint64_t dataOffset;   // The position of the first section
+    uint64_t namesOffset;  // The position of the names (0 if the nodes are unnamed)
+    uint64_t length;       // The length of the whole file, to detect truncated files
+    uint8_t reserved[8];   // Always 0, pads the header to a cache line
+};
+
+static_assert(sizeof(BinaryHeader) == 64, "The binary header must keep the same size on every platform");
+
+#endif // BINARYFORMAT_H
@@ -0,0 +1,355 @@
+#ifndef CELLTYPE_H
+#define CELLTYPE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * @brief The integer type used to store each cell of a Matrice.
+ * The maximum value of each type is reserved to represent "infinity" (no path), so it is never used for an actual weight.
+ */
+enum class CellType : uint8_t {
+    Int8,
+    Int16,
+    Int32,
+    Int64
+};
+
+/**
+ * @brief Get the size (in bytes) of a cell of the given type.
+ * @param type The cell type.
+ * @return The size of a cell.
+ */
+inline size_t cellSize(CellType type)
+{
+    switch (type) {
+        case CellType::Int8:  return sizeof(int8_t);
+        case CellType::Int16: return sizeof(int16_t);
+        case CellType::Int32: return sizeof(int32_t);
+        default:              return sizeof(int64_t);
+    }
+}
+
+/**
+ * @brief Get the narrowest cell type able to store every value between min and max (both included).
+ * The maximum value of the type is excluded, as it is reserved for infinity.
+ * @param min The smallest value to store.
+ * @param max The largest value to store.
+ * @return The narrowest fitting cell type.
+ */
+inline CellType fittingCellType(int64_t min, int64_t max)
+{
+    if (min >= INT8_MIN && max < INT8_MAX) return CellType::Int8;
+    if (min >= INT16_MIN && max < INT16_MAX) return CellType::Int16;
+    if (min >= INT32_MIN && max < INT32_MAX) return CellType::Int32;
+    return CellType::Int64;
+}
+
+/**
+ * @brief Call a (generic) function with a value of the C++ type matching the given cell type.
+ * This is used to instantiate the templated algorithms for each cell type, with a single switch per call.
+ * Example: `dispatchCellType(type, [&](auto tag) { using T = decltype(tag); ... });`
+ * @param type The cell type.
+ * @param function The function to call, taking the C++ type as a (value-initialized) argument.
+ * @return The value returned by the function.
+ */
+template<typename Function>
+inline auto dispatchCellType(CellType type, Function&& function)
+{
+    switch (type) {
+        case CellType::Int8:  return function(int8_t());
+        case CellType::Int16: return function(int16_t());
+        case CellType::Int32: return function(int32_t());
+        default:              return function(int64_t());
+    }
+}
+
+/**
+ * @brief Count the number of trailing zero bits of a (non-zero) word, i.e. the index of its lowest set bit.
+ * @param word The word (must not be 0).
+ * @return The index of the lowest set bit.
+ */
+inline uint32_t countTrailingZeros(uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return index;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+/**
+ * @brief Accessor to the cells of a dense matrix stored row by row with the C++ type `T`.
+ * Reading a cell maps the maximum of `T` (infinity) to INT64_MAX.
+ */
+template<typename T>
+struct DenseCells {
+    /**
+     * @brief The first cell of the matrix.
+     */
+    T* data;
+
+    /**
+     * @brief The number of cells between the start of two consecutive rows.
+     */
+    uint32_t stride;
+
+    /**
+     * @brief The number of rows and columns.
+     */
+    uint32_t size;
+
+    /**
+     * @brief Get a pointer to the first cell of a row.
+     */
+    inline T* row(uint32_t i) const { return data + static_cast<size_t>(i) * stride; }
+
+    /**
+     * @brief Get the value of a cell (INT64_MAX for infinity).
+     */
+    inline int64_t get(uint32_t i, uint32_t j) const
+    {
+        T value = row(i)[j];
+        return value == std::numeric_limits<T>::max() ? INT64_MAX : value;
+    }
+
+    /**
+     * @brief Check whether a cell is non-zero (i.e. the edge exists).
+     */
+    inline bool has(uint32_t i, uint32_t j) const { return row(i)[j] != 0; }
+
+    /**
+     * @brief Set the value of a cell.
+     */
+    inline void set(uint32_t i, uint32_t j, int64_t value) const { row(i)[j] = static_cast<T>(value); }
+
+    /**
+     * @brief Call a function with the column and value of each non-zero cell of a row, in increasing column order.
+     */
+    template<typename Function>
+    inline void forEachInRow(uint32_t i, Function&& function) const
+    {
+        const T* cells = row(i);
+        for (uint32_t j = 0; j < size; j++) {
+            if (cells[j] != 0) function(j, get(i, j));
+        }
+    }
+
+    /**
+     * @brief Find the next non-zero cell of a row, for walks which stop and resume later (ex. an iterative depth-first search).
+     * @param i The row.
+     * @param position Where to resume (0 for the start of the row), moved after the cell found.
+     * @return The column of the cell, or `size` if there is no non-zero cell left in the row.
+     */
+    inline uint32_t nextInRow(uint32_t i, uint64_t& position) const
+    {
+        const T* cells = row(i);
+        uint32_t j = static_cast<uint32_t>(position);
+        while (j < size && cells[j] == 0) j++;
+        position = j + 1;
+        return j;
+    }
+};
+
+/**
+ * @brief Accessor to the cells of a bit matrix (unweighted graph), with 64 cells per word.
+ * The cell (i, j) is the bit `j % 64` of the word `j / 64` of the row `i`.
+ */
+struct BitCells {
+    /**
+     * @brief The first word of the matrix.
+     */
+    uint64_t* data;
+
+    /**
+     * @brief The number of words between the start of two consecutive rows.
+     */
+    uint32_t stride;
+
+    /**
+     * @brief The number of rows and columns.
+     */
+    uint32_t size;
+
+    /**
+     * @brief Get a pointer to the first word of a row.
+     */
+    inline uint64_t* row(uint32_t i) const { return data + static_cast<size_t>(i) * stride; }
+
+    /**
+     * @brief Get the value of a cell (0 or 1).
+     */
+    inline int64_t get(uint32_t i, uint32_t j) const { return (row(i)[j >> 6] >> (j & 63)) & 1; }
+
+    /**
+     * @brief Check whether a cell is set (i.e. the edge exists).
+     */
+    inline bool has(uint32_t i, uint32_t j) const { return get(i, j) != 0; }
+
+    /**
+     * @brief Set the value of a cell (any non-zero value sets the bit).
+     */
+    inline void set(uint32_t i, uint32_t j, int64_t value) const
+    {
+        if (value != 0) row(i)[j >> 6] |= uint64_t(1) << (j & 63);
+        else row(i)[j >> 6] &= ~(uint64_t(1) << (j & 63));
+    }
+
+    /**
+     * @brief Call a function with the column and value (always 1) of each set cell of a row, in increasing column order.
+     * Empty words are skipped with a single test, and set bits are found with `countTrailingZeros`.
+     */
+    template<typename Function>
+    inline void forEachInRow(uint32_t i, Function&& function) const
+    {
+        const uint64_t* words = row(i);
+        for (uint32_t word = 0; word * 64 < size; word++) {
+            for (uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {  // Clear the lowest set bit at each step
+                function(word * 64 + countTrailingZeros(bits), int64_t(1));
+            }
+        }
+    }
+
+    /**
+     * @brief Find the next set cell of a row, for walks which stop and resume later (ex. an iterative depth-first search).
+     * The bits before the position are masked out of its word, then empty words are skipped with a single test.
+     * @param i The row.
+     * @param position Where to resume (0 for the start of the row), moved after the cell found.
+     * @return The column of the cell, or `size` if there is no set cell left in the row.
+     */
+    inline uint32_t nextInRow(uint32_t i, uint64_t& position) const
+    {
+        const uint64_t* words = row(i);
+        uint32_t word = static_cast<uint32_t>(position >> 6);
+        if (position >= size) return size;
+        uint64_t bits = words[word] & (~uint64_t(0) << (position & 63));
+        while (bits == 0) {
+            if (++word * 64 >= size) {
+                position = size;
+                return size;
+            }
+            bits = words[word];
+        }
+        uint32_t j = word * 64 + countTrailingZeros(bits);
+        position = j + 1;
+        return j;
+    }
+};
+
+/**
+ * @brief Compressed sparse rows: only the non-zero cells of each row are stored, sorted by column.
+ */
+struct SparseRows {
+    /**
+     * @brief For each row `i`, its cells are at the indexes [offsets[i], offsets[i + 1]) of `columns` and `weights` (size + 1 entries).
+     */
+    uint64_t* offsets = nullptr;
+
+    /**
+     * @brief The column of each stored cell.
+     */
+    uint32_t* columns = nullptr;
+
+    /**
+     * @brief The value of each stored cell, with the C++ type matching the cell type.
+     */
+    void* weights = nullptr;
+};
+
+/**
+ * @brief Accessor to the cells of a sparse matrix (compressed sparse rows) whose values have the C++ type `T`.
+ * Reading a cell is a binary search in its row, walking a row only visits its non-zero cells.
+ */
+template<typename T>
+struct SparseCells {
+    /**
+     * @brief The offsets of the rows.
+     */
+    const uint64_t* offsets;
+
+    /**
+     * @brief The column of each stored cell.
+     */
+    const uint32_t* columns;
+
+    /**
+     * @brief The value of each stored cell.
+     */
+    const T* weights;
+
+    /**
+     * @brief The number of rows and columns.
+     */
+    uint32_t size;
+
+    /**
+     * @brief Get the value of a cell (0 if not stored, INT64_MAX for infinity).
+     */
+    inline int64_t get(uint32_t i, uint32_t j) const
+    {
+        const uint32_t* begin = columns + offsets[i];
+        const uint32_t* end = columns + offsets[i + 1];
+        const uint32_t* found = std::lower_bound(begin, end, j);
+        if (found == end || *found != j) return 0;
+        T value = weights[found - columns];
+        return value == std::numeric_limits<T>::max() ? INT64_MAX : value;
+    }
+
+    /**
+     * @brief Check whether a cell is non-zero (i.e. the edge exists).
+     */
+    inline bool has(uint32_t i, uint32_t j) const { return get(i, j) != 0; }
+
+    /**
+     * @brief Call a function with the column and value of each non-zero cell of a row, in increasing column order.
+     */
+    template<typename Function>
+    inline void forEachInRow(uint32_t i, Function&& function) const
+    {
+        for (uint64_t k = offsets[i]; k < offsets[i + 1]; k++) {
+            T value = weights[k];
+            function(columns[k], value == std::numeric_limits<T>::max() ? INT64_MAX : int64_t(value));
+        }
+    }
+
+    /**
+     * @brief Find the next non-zero cell of a row, for walks which stop and resume later (ex. an iterative depth-first search).
+     * @param i The row.
+     * @param position Where to resume (0 for the start of the row), moved after the cell found: here, the rank of the cell in its row.
+     * @return The column of the cell, or `size` if there is no non-zero cell left in the row.
+     */
+    inline uint32_t nextInRow(uint32_t i, uint64_t& position) const
+    {
+        uint64_t k = offsets[i] + position;
+        if (k >= offsets[i + 1]) return size;
+        position++;
+        return columns[k];
+    }
+};
+
+/**
+ * @brief Transpose, in place, a 64x64 block of bits stored as 64 words (bit `j` of word `i` is the cell (i, j)).
+ * @param block The 64 words of the block.
+ */
+inline void transposeBitBlock(uint64_t* block)
+{
+    // Swap the off-diagonal sub-blocks, halving their size at each step (32x32, 16x16, ..., 1x1)
+    uint64_t mask = 0x00000000FFFFFFFFull;
+    for (uint32_t width = 32; width != 0; width >>= 1, mask ^= mask << width) {
+        for (uint32_t k = 0; k < 64; k = ((k | width) + 1) & ~width) {
+            uint64_t swapped = ((block[k] >> width) ^ block[k | width]) & mask;
+            block[k] ^= swapped << width;
+            block[k | width] ^= swapped;
+        }
+    }
+}
+
+#endif // CELLTYPE_H
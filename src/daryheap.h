@@ -0,0 +1,153 @@
+#ifndef DARYHEAP_H
+#define DARYHEAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief An indexed d-ary min-heap of items 0 to capacity-1, each with a key, supporting decrease-key.
+ * With 4 children per node, the heap is half as deep as a binary one, so decrease-keys (the most frequent operation
+ * of graph algorithms) move items up fewer levels, while pops compare a few more children, stored next to each other.
+ */
+template<typename Key, uint32_t Arity = 4>
+class DaryHeap
+{
+public:
+    /**
+     * @brief Construct an empty heap.
+     * @param capacity The number of items (items are the integers in [0, capacity)).
+     */
+    explicit DaryHeap(uint32_t capacity):
+        keys(capacity),
+        positions(capacity, ABSENT)
+    {
+        heap.reserve(capacity);
+    }
+
+    /**
+     * @brief Check whether the heap is empty.
+     */
+    bool empty() const { return heap.empty(); }
+
+    /**
+     * @brief Check whether an item is in the heap.
+     */
+    bool contains(uint32_t item) const { return positions[item] != ABSENT; }
+
+    /**
+     * @brief Get the key of an item (only meaningful if it is, or was, in the heap).
+     */
+    Key key(uint32_t item) const { return keys[item]; }
+
+    /**
+     * @brief Insert an item, or decrease its key if it is already in the heap (a larger key is ignored).
+     * @param item The item.
+     * @param key The key of the item.
+     */
+    void push(uint32_t item, Key key)
+    {
+        if (positions[item] == ABSENT) {
+            positions[item] = static_cast<uint32_t>(heap.size());
+            heap.push_back(item);
+        } else if (!(key < keys[item])) {
+            return;
+        }
+        keys[item] = key;
+        siftUp(positions[item]);
+    }
+
+    /**
+     * @brief Remove the item with the smallest key.
+     * @return The removed item (the heap must not be empty).
+     */
+    uint32_t pop()
+    {
+        uint32_t top = heap[0];
+        positions[top] = ABSENT;
+        uint32_t last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            positions[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    /**
+     * @brief Remove every item, keeping the capacity (linear in the number of removed items).
+     */
+    void clear()
+    {
+        for (uint32_t item : heap) positions[item] = ABSENT;
+        heap.clear();
+    }
+
+private:
+    /**
+     * @brief The position of an item which is not in the heap.
+     */
+    static constexpr uint32_t ABSENT = UINT32_MAX;
+
+    /**
+     * @brief Move an item up until its parent has a smaller or equal key.
+     */
+    void siftUp(uint32_t position)
+    {
+        uint32_t item = heap[position];
+        Key itemKey = keys[item];
+        while (position > 0) {
+            uint32_t parent = (position - 1) / Arity;
+            if (!(itemKey < keys[heap[parent]])) break;
+            heap[position] = heap[parent];
+            positions[heap[position]] = position;
+            position = parent;
+        }
+        heap[position] = item;
+        positions[item] = position;
+    }
+
+    /**
+     * @brief Move an item down until its children have larger or equal keys.
+     */
+    void siftDown(uint32_t position)
+    {
+        uint32_t item = heap[position];
+        Key itemKey = keys[item];
+        const uint32_t count = static_cast<uint32_t>(heap.size());
+        while (true) {
+            // Find the child with the smallest key
+            uint64_t first = static_cast<uint64_t>(position) * Arity + 1;
+            if (first >= count) break;
+            uint32_t best = static_cast<uint32_t>(first);
+            uint32_t end = static_cast<uint32_t>(std::min<uint64_t>(first + Arity, count));
+            for (uint32_t child = best + 1; child < end; child++) {
+                if (keys[heap[child]] < keys[heap[best]]) best = child;
+            }
+            if (!(keys[heap[best]] < itemKey)) break;
+            heap[position] = heap[best];
+            positions[heap[position]] = position;
+            position = best;
+        }
+        heap[position] = item;
+        positions[item] = position;
+    }
+
+    /**
+     * @brief The items, ordered as a d-ary heap (the children of position `p` are at `p * Arity + 1` to `p * Arity + Arity`).
+     */
+    std::vector<uint32_t> heap;
+
+    /**
+     * @brief The key of each item.
+     */
+    std::vector<Key> keys;
+
+    /**
+     * @brief The position of each item in `heap`, or ABSENT.
+     */
+    std::vector<uint32_t> positions;
+};
+
+#endif // DARYHEAP_H
@@ -0,0 +1,200 @@
+#include "dynamicshortestpaths.h"
+
+#include "daryheap.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+/******************************
+| Constructors and Destructor |
+******************************/
+
+DynamicShortestPaths::DynamicShortestPaths(const Matrice& graph, const Matrice* paths):
+    size(graph.getSize()),
+    weights(static_cast<size_t>(size) * size),
+    distances(static_cast<size_t>(size) * size)
+{
+    // Compute the shortest paths if they are not given
+    const Matrice* ownPaths = paths == nullptr ? graph.shortestPaths() : nullptr;
+    if (ownPaths != nullptr) paths = ownPaths;
+
+    // Copy the weights and the distances (a missing edge is an infinite weight)
+    for (uint32_t i = 0; i < size; i++) {
+        for (uint32_t j = 0; j < size; j++) {
+            int64_t weight = graph.getEdge(i, j);
+            weights[static_cast<size_t>(i) * size + j] = weight == 0 ? INT64_MAX : weight;
+            distances[static_cast<size_t>(i) * size + j] = paths->getEdge(i, j);
+        }
+    }
+    delete ownPaths;
+
+    // A negative cycle makes every path through it undefined
+    for (uint32_t i = 0; i < size; i++) {
+        if (distances[static_cast<size_t>(i) * size + i] < 0) {
+            throw std::runtime_error("The graph contains a negative cycle, so it has no shortest paths.");
+        }
+    }
+}
+
+/**********************
+| Getters and Setters |
+**********************/
+
+uint32_t DynamicShortestPaths::getSize() const
+{
+    return size;
+}
+
+int64_t DynamicShortestPaths::getWeight(uint32_t from, uint32_t to) const
+{
+    int64_t weight = weights[static_cast<size_t>(from) * size + to];
+    return weight == INT64_MAX ? 0 : weight;
+}
+
+int64_t DynamicShortestPaths::getDistance(uint32_t from, uint32_t to) const
+{
+    return distances[static_cast<size_t>(from) * size + to];
+}
+
+/**********
+| Updates |
+**********/
+
+std::vector<DynamicShortestPaths::CellChange> DynamicShortestPaths::update(uint32_t from, uint32_t to, int64_t weight)
+{
+    std::vector<CellChange> changes;
+    int64_t& edge = weights[static_cast<size_t>(from) * size + to];
+    int64_t previous = edge;
+    int64_t next = weight == 0 ? INT64_MAX : weight;
+    if (next < previous) {
+        // The edge closes a negative cycle if it is shorter than the opposite of the shortest path coming back
+        int64_t back = pathLength(to, from);
+        if (back != INT64_MAX && back + next < 0) {
+            throw std::runtime_error("This weight would create a negative cycle, so the graph would have no shortest paths.");
+        }
+        edge = next;
+        decrease(from, to, next, changes);
+    } else if (next > previous) {
+        edge = next;
+        increase(from, to, previous, changes);
+    }
+    return changes;
+}
+
+std::vector<DynamicShortestPaths::CellChange> DynamicShortestPaths::update(const std::vector<EdgeUpdate>& updates)
+{
+    // Merge the changes of each update, keeping the first previous distance of each cell
+    std::vector<CellChange> changes;
+    std::unordered_map<uint64_t, size_t> indexes;
+    for (const EdgeUpdate& edgeUpdate : updates) {
+        for (const CellChange& change : update(edgeUpdate.from, edgeUpdate.to, edgeUpdate.weight)) {
+            auto [index, inserted] = indexes.try_emplace(static_cast<uint64_t>(change.from) * size + change.to, changes.size());
+            if (inserted) {
+                changes.push_back(change);
+            } else {
+                changes[index->second].after = change.after;
+            }
+        }
+    }
+
+    // Drop the cells which came back to their first distance
+    size_t kept = 0;
+    for (const CellChange& change : changes) {
+        if (change.before != change.after) changes[kept++] = change;
+    }
+    changes.resize(kept);
+    return changes;
+}
+
+void DynamicShortestPaths::decrease(uint32_t from, uint32_t to, int64_t weight, std::vector<CellChange>& changes)
+{
+    // Without negative cycles, a new shortest path uses the edge at most once: i >> ... >> from >> to >> ... >> j.
+    // Cells updated during the loop are still lengths of real paths, no shorter than the ones through the edge only once
+    for (uint32_t i = 0; i < size; i++) {
+        int64_t before = pathLength(i, from);
+        if (before == INT64_MAX) continue;
+        before += weight;
+
+        // If the path to `to` is not shorter through the edge, neither are the paths going on from `to`
+        int64_t* row = &distances[static_cast<size_t>(i) * size];
+        if (before >= row[to]) continue;
+        for (uint32_t j = 0; j < size; j++) {
+            int64_t after = pathLength(to, j);
+            if (after == INT64_MAX || before + after >= row[j]) continue;
+            changes.push_back({i, j, row[j], before + after});
+            row[j] = before + after;
+        }
+    }
+}
+
+void DynamicShortestPaths::increase(uint32_t from, uint32_t to, int64_t previous, std::vector<CellChange>& changes)
+{
+    // Keep the previous paths from the end of the edge (its row is recomputed too, but the previous paths tell which ones used the edge)
+    std::vector<int64_t> fromEdge(size);
+    for (uint32_t j = 0; j < size; j++) fromEdge[j] = pathLength(to, j);
+
+    std::vector<bool> affected(size);
+    std::vector<int64_t> before(size);
+    DaryHeap<int64_t> heap(size);
+    for (uint32_t i = 0; i < size; i++) {
+        // Skip the sources whose shortest path to `to` did not use the edge: none of their shortest paths did
+        int64_t toEdge = pathLength(i, from);
+        int64_t* row = &distances[static_cast<size_t>(i) * size];
+        if (toEdge == INT64_MAX || toEdge + previous != row[to]) continue;
+
+        // Find the destinations which may have used the edge (the others are still shortest paths), and reset them
+        bool any = false;
+        for (uint32_t j = 0; j < size; j++) {
+            affected[j] = fromEdge[j] != INT64_MAX && toEdge + previous + fromEdge[j] == row[j];
+            if (!affected[j]) continue;
+            any = true;
+            before[j] = row[j];
+            row[j] = INT64_MAX;
+        }
+        if (!any) continue;
+
+        // Start each affected destination from its best predecessor with a valid path (the source itself being at distance 0)
+        for (uint32_t j = 0; j < size; j++) {
+            if (!affected[j] || j == i) continue;
+            int64_t best = INT64_MAX;
+            for (uint32_t p = 0; p < size; p++) {
+                int64_t weight = weights[static_cast<size_t>(p) * size + j];
+                if (weight == INT64_MAX || (affected[p] && p != i)) continue;
+                int64_t length = p == i ? 0 : row[p];
+                if (length != INT64_MAX && length + weight < best) best = length + weight;
+            }
+            if (best != INT64_MAX) {
+                row[j] = best;
+                heap.push(j, best);
+            }
+        }
+
+        // Then propagate between the affected destinations, by increasing distance (a destination is pushed again if a negative edge shortens it)
+        while (!heap.empty()) {
+            uint32_t node = heap.pop();
+            const int64_t* edges = &weights[static_cast<size_t>(node) * size];
+            for (uint32_t j = 0; j < size; j++) {
+                if (edges[j] == INT64_MAX || !affected[j] || j == i) continue;
+                int64_t length = row[node] + edges[j];
+                if (length < row[j]) {
+                    row[j] = length;
+                    heap.push(j, length);
+                }
+            }
+        }
+
+        // The cycle through the source comes back from any predecessor, once the other paths are known
+        if (affected[i]) {
+            for (uint32_t p = 0; p < size; p++) {
+                int64_t weight = weights[static_cast<size_t>(p) * size + i];
+                int64_t length = pathLength(i, p);
+                if (weight != INT64_MAX && length != INT64_MAX && length + weight < row[i]) row[i] = length + weight;
+            }
+        }
+
+        // Report the destinations whose distance changed
+        for (uint32_t j = 0; j < size; j++) {
+            if (affected[j] && row[j] != before[j]) changes.push_back({i, j, before[j], row[j]});
+        }
+    }
+}
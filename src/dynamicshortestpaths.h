@@ -0,0 +1,145 @@
+#ifndef DYNAMICSHORTESTPATHS_H
+#define DYNAMICSHORTESTPATHS_H
+
+#include "matrice.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The shortest paths between all pairs of nodes of a graph whose weights change, kept up to date without recomputing them all.
+ * The distances are seeded from a full computation (see `Matrice::shortestPaths`), then each change of weight only updates the cells it affects:
+ * - a decrease can only shorten the paths through the edge, which are checked in O(n^2) at most (only from the sources whose path
+ *   to the end of the edge gets shorter) ;
+ * - an increase (or a removal) can only lengthen the paths which used the edge: only these pairs are recomputed,
+ *   from the paths which did not use it, in O(n) per recomputed pair.
+ * Like `Matrice::floydWarshall`, the cell (i, i) is the shortest cycle through `i`, and missing paths are INT64_MAX.
+ */
+class DynamicShortestPaths
+{
+
+public:
+    /**
+     * @brief A change of the weight of an edge.
+     */
+    struct EdgeUpdate {
+        uint32_t from;
+        uint32_t to;
+        int64_t weight;  // The new weight (0 removes the edge, as in the matrix files)
+    };
+
+    /**
+     * @brief A cell of the distances changed by updates.
+     */
+    struct CellChange {
+        uint32_t from;
+        uint32_t to;
+        int64_t before;  // The previous distance (INT64_MAX if there was no path)
+        int64_t after;   // The new distance (INT64_MAX if there is no path anymore)
+    };
+
+    /******************************
+    | Constructors and Destructor |
+    ******************************/
+
+    /**
+     * @brief Construct a new DynamicShortestPaths object, from the weights of a graph and its shortest paths.
+     * @param graph The graph (it is copied, so it can be deleted afterwards).
+     * @param paths The shortest paths of the graph (see `Matrice::shortestPaths`), or nullptr to compute them.
+     * @throws std::runtime_error if the graph contains a negative cycle.
+     */
+    DynamicShortestPaths(const Matrice& graph, const Matrice* paths = nullptr);
+
+    /**********************
+    | Getters and Setters |
+    **********************/
+
+    /**
+     * @brief Get the number of nodes of the graph.
+     * @return The number of nodes.
+     */
+    uint32_t getSize() const;
+
+    /**
+     * @brief Get the current weight of an edge.
+     * @param from The index of the source node.
+     * @param to The index of the destination node.
+     * @return The weight of the edge, or 0 if there is no edge.
+     */
+    int64_t getWeight(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Get the current length of the shortest path between two nodes.
+     * @param from The index of the source node.
+     * @param to The index of the destination node (if it is `from`, the length of the shortest cycle through it).
+     * @return The length of the shortest path, or INT64_MAX if there is no path.
+     */
+    int64_t getDistance(uint32_t from, uint32_t to) const;
+
+    /**********
+    | Updates |
+    **********/
+
+    /**
+     * @brief Change the weight of an edge, and update the shortest paths.
+     * For an undirected graph, both directions of the edge must be updated.
+     * @param from The index of the source node.
+     * @param to The index of the destination node.
+     * @param weight The new weight (0 removes the edge).
+     * @return The cells of the distances which changed.
+     * @throws std::runtime_error if the new weight creates a negative cycle (the update is then ignored).
+     */
+    std::vector<CellChange> update(uint32_t from, uint32_t to, int64_t weight);
+
+    /**
+     * @brief Change the weights of several edges, in order, and update the shortest paths.
+     * @param updates The changes of weight.
+     * @return The cells of the distances which changed, each one only once (with its distances before the first update and after the last one).
+     * @throws std::runtime_error if an update creates a negative cycle (the previous updates are kept, the following ones are ignored).
+     */
+    std::vector<CellChange> update(const std::vector<EdgeUpdate>& updates);
+
+private:
+    /**
+     * @brief Shorten the paths which are shorter through a new or decreased edge.
+     * @param from The source of the edge.
+     * @param to The destination of the edge.
+     * @param weight The new weight of the edge (finite).
+     * @param changes Receives the changed cells.
+     */
+    void decrease(uint32_t from, uint32_t to, int64_t weight, std::vector<CellChange>& changes);
+
+    /**
+     * @brief Recompute the paths which went through an increased or removed edge.
+     * @param from The source of the edge.
+     * @param to The destination of the edge.
+     * @param previous The previous weight of the edge (finite).
+     * @param changes Receives the changed cells.
+     */
+    void increase(uint32_t from, uint32_t to, int64_t previous, std::vector<CellChange>& changes);
+
+    /**
+     * @brief Get the length of the shortest path between two nodes, where a node is at distance 0 of itself (instead of its cycle).
+     */
+    int64_t pathLength(uint32_t from, uint32_t to) const
+    {
+        return from == to ? 0 : distances[static_cast<size_t>(from) * size + to];
+    }
+
+    /**
+     * @brief The number of nodes.
+     */
+    uint32_t size;
+
+    /**
+     * @brief The weight of each edge, row by row (INT64_MAX if there is no edge).
+     */
+    std::vector<int64_t> weights;
+
+    /**
+     * @brief The length of each shortest path, row by row (INT64_MAX if there is no path).
+     */
+    std::vector<int64_t> distances;
+};
+
+#endif // DYNAMICSHORTESTPATHS_H
@@ -0,0 +1,232 @@
+#include "forcelayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/******************************
+| Constructors and Destructor |
+******************************/
+
+ForceLayout::ForceLayout(const std::vector<Point>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, double edgeLength):
+    positions(positions),
+    edgeLength(edgeLength),
+    temperature(LAYOUT_START_TEMPERATURE * edgeLength),
+    leaves(positions.size()),
+    forces(positions.size())
+{
+    // Each pair of linked nodes pulls once, whatever the direction and the number of its edges
+    for (const std::pair<uint32_t, uint32_t>& edge : edges) {
+        if (edge.first != edge.second) this->edges.push_back(std::minmax(edge.first, edge.second));
+    }
+    std::sort(this->edges.begin(), this->edges.end());
+    this->edges.erase(std::unique(this->edges.begin(), this->edges.end()), this->edges.end());
+
+    // The pulls are weaker in dense graphs, which would otherwise be packed in a small ball where the nodes overlap
+    pullScale = this->edges.empty() ? 1 : std::min(1.0, LAYOUT_DEGREE * positions.size() / (2.0 * this->edges.size()));
+
+    // A graph without two nodes is already laid out
+    converged = positions.size() < 2;
+}
+
+/**********************
+| Getters and Setters |
+**********************/
+
+const std::vector<ForceLayout::Point>& ForceLayout::getPositions() const
+{
+    return positions;
+}
+
+uint32_t ForceLayout::getIterations() const
+{
+    return iterations;
+}
+
+bool ForceLayout::isConverged() const
+{
+    return converged;
+}
+
+/*************
+| Iterations |
+*************/
+
+double ForceLayout::step()
+{
+    if (converged) return 0;
+    const uint32_t size = positions.size();
+
+    // The nodes push each other away (k^2 / d), approximated with the quadtree
+    buildTree();
+    std::vector<uint32_t> stack;
+    for (uint32_t node = 0; node < size; node++) {
+        forces[node] = repulsion(node, stack);
+    }
+
+    // The edges pull their nodes together (d^2 / k)
+    for (const std::pair<uint32_t, uint32_t>& edge : edges) {
+        const Point& from = positions[edge.first];
+        const Point& to = positions[edge.second];
+        double dx = to.x - from.x;
+        double dy = to.y - from.y;
+        double pull = std::hypot(dx, dy) / edgeLength * pullScale;
+        forces[edge.first].x += dx * pull;
+        forces[edge.first].y += dy * pull;
+        forces[edge.second].x -= dx * pull;
+        forces[edge.second].y -= dy * pull;
+    }
+
+    // Every node is pulled toward the center of the nodes (the root of the quadtree holds their sum), and moves along its force,
+    // by at most the temperature
+    const Cell& root = cells[0];
+    double centerX = root.sumX / root.mass;
+    double centerY = root.sumY / root.mass;
+    double largestMove = 0;
+    double energy = 0;
+    for (uint32_t node = 0; node < size; node++) {
+        Point& position = positions[node];
+        double forceX = forces[node].x + (centerX - position.x) * LAYOUT_GRAVITY;
+        double forceY = forces[node].y + (centerY - position.y) * LAYOUT_GRAVITY;
+        double force = std::hypot(forceX, forceY);
+        if (force == 0 || !std::isfinite(force)) continue;
+        double move = std::min(force, temperature);
+        position.x += forceX / force * move;
+        position.y += forceY / force * move;
+        largestMove = std::max(largestMove, move);
+        energy += force * force;
+    }
+
+    // Adapt the temperature (Hu's adaptive cooling): it is raised after a few iterations in a row lowering the forces,
+    // so that the nodes far from their place (ex. on the large circle of the initial positions) move faster, and lowered otherwise,
+    // so that the layout settles even if the forces never cancel out exactly
+    if (energy < previousEnergy) {
+        if (++progress >= LAYOUT_HEATING_STEPS) {
+            progress = 0;
+            temperature /= LAYOUT_COOLING;
+        }
+    } else {
+        progress = 0;
+        temperature *= LAYOUT_COOLING;
+    }
+    previousEnergy = energy;
+    iterations++;
+    converged = largestMove < LAYOUT_CONVERGENCE * edgeLength;
+    return largestMove;
+}
+
+void ForceLayout::buildTree()
+{
+    // The root is the smallest square holding every node
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (const Point& position : positions) {
+        minX = std::min(minX, position.x);
+        minY = std::min(minY, position.y);
+        maxX = std::max(maxX, position.x);
+        maxY = std::max(maxY, position.y);
+    }
+    cells.clear();
+    cells.push_back(Cell{minX, minY, std::max({maxX - minX, maxY - minY, edgeLength})});
+
+    // Add the nodes one at a time, from the root down to an empty leaf, splitting the leaf of another node on the way
+    for (uint32_t node = 0; node < positions.size(); node++) {
+        const Point& position = positions[node];
+        uint32_t cell = 0;
+        for (uint32_t depth = 0; ; depth++) {
+            cells[cell].sumX += position.x;
+            cells[cell].sumY += position.y;
+            cells[cell].mass++;
+            if (cells[cell].firstChild == 0) {
+                // The nodes at the same position share a leaf of the maximum depth (the first one is kept)
+                if (cells[cell].node == UINT32_MAX || depth == LAYOUT_MAX_DEPTH) {
+                    if (cells[cell].node == UINT32_MAX) cells[cell].node = node;
+                    leaves[node] = cell;
+                    break;
+                }
+                split(cell);
+            }
+
+            // Go down to the child holding the position
+            const Cell& parent = cells[cell];
+            double half = parent.size / 2;
+            cell = parent.firstChild + (position.x >= parent.x + half) + 2 * (position.y >= parent.y + half);
+        }
+    }
+}
+
+void ForceLayout::split(uint32_t cell)
+{
+    // Add the 4 children (which may move the cells in memory, so the parent is copied)
+    Cell parent = cells[cell];
+    double half = parent.size / 2;
+    uint32_t firstChild = cells.size();
+    for (uint32_t quarter = 0; quarter < 4; quarter++) {
+        cells.push_back(Cell{parent.x + (quarter & 1) * half, parent.y + (quarter >> 1) * half, half});
+    }
+    cells[cell].firstChild = firstChild;
+    cells[cell].node = UINT32_MAX;
+
+    // Move the node of the leaf to its child
+    const Point& position = positions[parent.node];
+    Cell& child = cells[firstChild + (position.x >= parent.x + half) + 2 * (position.y >= parent.y + half)];
+    child.sumX = position.x;
+    child.sumY = position.y;
+    child.mass = 1;
+    child.node = parent.node;
+    leaves[parent.node] = &child - cells.data();
+}
+
+ForceLayout::Point ForceLayout::repulsion(uint32_t node, std::vector<uint32_t>& stack) const
+{
+    const Point& position = positions[node];
+    const double squaredLength = edgeLength * edgeLength;
+    Point force{0, 0};
+
+    // Add the push of nodes at a position (k^2 / d each, along the line from the position to the node)
+    auto push = [&](double x, double y, uint32_t mass) {
+        double dx = position.x - x;
+        double dy = position.y - y;
+        double squaredDistance = dx * dx + dy * dy;
+
+        // Nodes at the same position are pushed in a direction given by each node, so that they split apart
+        if (squaredDistance < 1e-6 * squaredLength) {
+            dx = std::cos(node) * 1e-3 * edgeLength;
+            dy = std::sin(node) * 1e-3 * edgeLength;
+            squaredDistance = dx * dx + dy * dy;
+        }
+        force.x += dx * squaredLength * mass / squaredDistance;
+        force.y += dy * squaredLength * mass / squaredDistance;
+    };
+
+    // Walk the quadtree from the root, stopping at the cells far enough to push as a single body
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        const Cell& cell = cells[index];
+        if (cell.mass == 0) continue;
+
+        // A leaf pushes with the other nodes inside it (the ones sharing a leaf of the maximum depth)
+        if (cell.firstChild == 0) {
+            bool own = leaves[node] == index;
+            uint32_t mass = cell.mass - own;
+            if (mass > 0) push((cell.sumX - own * position.x) / mass, (cell.sumY - own * position.y) / mass, mass);
+            continue;
+        }
+
+        // Another cell pushes as a single body from its center of mass if it is small enough from the node, and with its children otherwise
+        double centerX = cell.sumX / cell.mass;
+        double centerY = cell.sumY / cell.mass;
+        double squaredDistance = (position.x - centerX) * (position.x - centerX) + (position.y - centerY) * (position.y - centerY);
+        if (cell.size * cell.size < LAYOUT_THETA * LAYOUT_THETA * squaredDistance) {
+            push(centerX, centerY, cell.mass);
+        } else {
+            for (uint32_t quarter = 0; quarter < 4; quarter++) stack.push_back(cell.firstChild + quarter);
+        }
+    }
+    return force;
+}
@@ -0,0 +1,195 @@
+#ifndef FORCELAYOUT_H
+#define FORCELAYOUT_H
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#define LAYOUT_THETA 0.9  // A cell of the quadtree pushes a node as a single body if its size is below LAYOUT_THETA times its distance (0 for the exact forces)
+#define LAYOUT_MAX_DEPTH 32  // Maximum depth of the quadtree (the nodes at the same position below it share a leaf)
+#define LAYOUT_DEGREE 2.0  // Average degree of the nodes above which the pulls of the edges are scaled down (by LAYOUT_DEGREE / degree)
+#define LAYOUT_GRAVITY 0.5  // Strength of the pull toward the center of the nodes, which keeps the parts of the graph which are not linked together
+#define LAYOUT_START_TEMPERATURE 1.0  // Largest move of a node in the first iteration, in edge lengths
+#define LAYOUT_COOLING 0.9  // Factor of the largest move of a node after an iteration which did not lower the forces (divided by it to raise it)
+#define LAYOUT_HEATING_STEPS 5  // Number of iterations in a row lowering the forces after which the largest move of a node is raised
+#define LAYOUT_CONVERGENCE 0.01  // The layout is done once no node moves more than this, in edge lengths
+
+/**
+ * @brief A force-directed layout of a graph (Fruchterman-Reingold): the nodes push each other away, while the edges pull their nodes
+ * together, until they settle. The pushes are approximated with a Barnes-Hut quadtree, in which the nodes far enough from a node
+ * push it as a single body, so that an iteration costs O(n log n + e) instead of O(n^2).
+ * The layout is computed one iteration at a time (see `step`), so that it can be shown as it settles, and stopped at any time.
+ */
+class ForceLayout
+{
+
+public:
+    /**
+     * @brief A position of a node.
+     */
+    struct Point {
+        double x;
+        double y;
+    };
+
+    /******************************
+    | Constructors and Destructor |
+    ******************************/
+
+    /**
+     * @brief Construct a new ForceLayout object.
+     * @param positions The initial position of each node (ex. the clusters placed on circles), which the layout starts from.
+     * @param edges The edges of the graph, as pairs of nodes (their direction and the loops are ignored).
+     * @param edgeLength The ideal length of an edge, around which the nodes settle.
+     */
+    ForceLayout(const std::vector<Point>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, double edgeLength);
+
+    /**********************
+    | Getters and Setters |
+    **********************/
+
+    /**
+     * @brief Get the current position of each node.
+     * @return The positions, in the order of the nodes.
+     */
+    const std::vector<Point>& getPositions() const;
+
+    /**
+     * @brief Get the number of iterations computed so far.
+     * @return The number of iterations.
+     */
+    uint32_t getIterations() const;
+
+    /**
+     * @brief Check whether the layout is done (no node moved more than LAYOUT_CONVERGENCE edge lengths in the last iteration).
+     * @return True if the layout is done.
+     */
+    bool isConverged() const;
+
+    /*************
+    | Iterations |
+    *************/
+
+    /**
+     * @brief Compute an iteration of the layout: each node moves along the forces applied to it, by at most the current temperature,
+     * which is then adapted (nothing is done once the layout is done).
+     * @return The largest move of a node.
+     */
+    double step();
+
+private:
+    /**
+     * @brief A square cell of the quadtree, summing the nodes inside it.
+     */
+    struct Cell {
+        /**
+         * @brief The corner with the smallest coordinates, and the side of the square.
+         */
+        double x;
+        double y;
+        double size;
+
+        /**
+         * @brief The sum of the positions of the nodes inside the cell (their center of mass, times their number).
+         */
+        double sumX = 0;
+        double sumY = 0;
+
+        /**
+         * @brief The number of nodes inside the cell.
+         */
+        uint32_t mass = 0;
+
+        /**
+         * @brief The index of the first of the 4 children of the cell, which follow each other, or 0 if the cell is a leaf.
+         */
+        uint32_t firstChild = 0;
+
+        /**
+         * @brief The node inside the leaf (the first one if it is at the maximum depth), or UINT32_MAX if there is none.
+         */
+        uint32_t node = UINT32_MAX;
+    };
+
+    /**
+     * @brief Build the quadtree of the current positions (sets `cells` and `leaves`).
+     */
+    void buildTree();
+
+    /**
+     * @brief Split a leaf of the quadtree in 4 children, moving its node to one of them.
+     * @param cell The index of the leaf.
+     */
+    void split(uint32_t cell);
+
+    /**
+     * @brief Compute the sum of the pushes of the other nodes on a node, with the quadtree.
+     * @param node The node.
+     * @param stack A buffer for the cells to visit (to avoid allocating it for each node).
+     * @return The sum of the pushes.
+     */
+    Point repulsion(uint32_t node, std::vector<uint32_t>& stack) const;
+
+    /**
+     * @brief The current position of each node.
+     */
+    std::vector<Point> positions;
+
+    /**
+     * @brief The edges of the graph, without their direction and without loops.
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+
+    /**
+     * @brief The ideal length of an edge.
+     */
+    double edgeLength;
+
+    /**
+     * @brief The factor of the pulls of the edges (below 1 if the average degree of the nodes is above LAYOUT_DEGREE).
+     */
+    double pullScale;
+
+    /**
+     * @brief The largest move of a node in the next iteration.
+     */
+    double temperature;
+
+    /**
+     * @brief The sum of the squared forces of the last iteration, to check whether the next one lowers them.
+     */
+    double previousEnergy = std::numeric_limits<double>::max();
+
+    /**
+     * @brief The number of iterations in a row which lowered the forces, since the temperature was last raised.
+     */
+    uint32_t progress = 0;
+
+    /**
+     * @brief The number of iterations computed so far.
+     */
+    uint32_t iterations = 0;
+
+    /**
+     * @brief Whether the layout is done.
+     */
+    bool converged = false;
+
+    /**
+     * @brief The cells of the quadtree, the first one being the root (rebuilt at each iteration, reusing the memory).
+     */
+    std::vector<Cell> cells;
+
+    /**
+     * @brief The leaf of the quadtree holding each node.
+     */
+    std::vector<uint32_t> leaves;
+
+    /**
+     * @brief The forces applied to each node in the current iteration (kept between iterations to reuse the memory).
+     */
+    std::vector<Point> forces;
+};
+
+#endif // FORCELAYOUT_H
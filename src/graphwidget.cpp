@@ -1,15 +1,27 @@
 #include "graphwidget.h"
 
+#include <QElapsedTimer>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QSignalBlocker>
 #include <QVBoxLayout>
 
-GraphWidget::GraphWidget(const Matrice* data, QWidget* parent):
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+GraphWidget::GraphWidget(const Matrice* data, const std::vector<std::vector<uint32_t>>& clusters, QWidget* parent):
     QWidget{parent},
-    matrice{data}
+    matrice{data},
+    clusters{clusters}
 {
-    // Compute strongly connected components
-    clusters = matrice->kosaraju();
+    // List the edges once, so that painting does not walk the whole matrice
+    for (uint32_t i = 0; i < matrice->getSize(); i++) {
+        for (uint32_t j = 0; j < matrice->getSize(); j++) {
+            int64_t weight = matrice->getEdge(i, j);
+            if (weight != 0) edges.push_back({i, j, weight});
+        }
+    }
 
     // Compute the positions and colors of the nodes
     nodes = nullptr;
@@ -40,29 +52,41 @@ GraphWidget::GraphWidget(const Matrice* data, QWidget* parent):
     zoomLayout->setAlignment(Qt::AlignRight | Qt::AlignTop);
     zoomLayout->setContentsMargins(0, 0, 10, 10);  // Margin to the right and bottom
 
+    // Create route label (hidden until routes or a source can be selected)
+    routeLabel = new QLabel(this);
+    routeLabel->setStyleSheet("color: white;");
+    routeLabel->setContentsMargins(10, 0, 0, 10);  // Margin to the left and bottom
+    routeLabel->setVisible(false);
+
     // Main layout
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
     mainLayout->addLayout(zoomLayout);
     mainLayout->addStretch();
+    mainLayout->addWidget(routeLabel);
     setLayout(mainLayout);
 
-    // Bind zoom to the slider
+    // Bind zoom to the slider (zooming on the center of the widget)
     connect(zoomSlider, &QSlider::valueChanged, this, [this](int value) {
-        zoom = static_cast<float>(value) / 100.0;
-        computeNodes();
-        update();
+        setZoom(static_cast<float>(value) / 100.0f, QPointF(width() / 2, height() / 2));
     });
+
+    // Improve the positions of the nodes in the background
+    startLayout();
 }
 
 GraphWidget::~GraphWidget()
 {
-    // Free the resources
-    /* if (matrice != nullptr) {
-        for (unsigned long long i = 0; i < clusters.size(); i++) {
-            delete nodes[clusters[i][0]].color;
-        }
-        delete[] nodes;
-    } */
+    // Stop the layout thread (once its current iteration ends), before freeing what it uses
+    stopLayout();
+    layoutThread->quit();
+    layoutThread->wait();
+    delete layout;
+
+    // Free the resources (each color is shared by the nodes of a cluster)
+    for (const std::vector<uint32_t>& cluster : clusters) {
+        if (!cluster.empty()) delete nodes[cluster[0]].color;
+    }
+    delete[] nodes;
 }
 
 void GraphWidget::forScreenshot(bool screenshot)
@@ -70,147 +94,215 @@ void GraphWidget::forScreenshot(bool screenshot)
     zoomSlider->setVisible(!screenshot);
 }
 
+void GraphWidget::setRoutes(const Matrice* distances, const Matrice* nextHops)
+{
+    this->distances = distances;
+    this->nextHops = nextHops;
+
+    // Show how to select a route
+    selectRouteNode(UINT32_MAX);
+    routeLabel->setVisible(true);
+}
+
+void GraphWidget::setSourceSelection()
+{
+    sourceSelection = true;
+
+    // Show how to select a source
+    selectSource(UINT32_MAX);
+    routeLabel->setVisible(true);
+}
+
 void GraphWidget::paintEvent(QPaintEvent* event)
 {
     Q_UNUSED(event);
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
 
-    // Compute the center of the widget (the graph positions are based on (0;0) and not on the center of the widget)
-    int centerX = width() / 2;
-    int centerY = height() / 2;
+    // Draw in graph coordinates: the zoom and the offset of the graph only change the transform of the painter
+    painter.setTransform(viewTransform());
+
+    // Only draw what can be seen (with a margin for the node names and the edge weights)
+    QRectF visible = viewTransform().inverted().mapRect(QRectF(rect())).adjusted(-NODE_SIZE, -NODE_SIZE, NODE_SIZE, NODE_SIZE);
+    auto isVisible = [&](const QLineF& line) {
+        return QRectF(line.p1(), line.p2()).normalized().adjusted(-1, -1, 1, 1).intersects(visible);  // Not empty, even if the line is straight
+    };
 
-    // Define the pen for drawing edges
+    // Define the pen for drawing edges (cosmetic, so that their width does not change with the zoom)
     QPen pen(Qt::white);
     pen.setWidth(EDGE_SIZE);
+    pen.setCosmetic(true);
     painter.setPen(pen);
     painter.setBrush(Qt::NoBrush);
 
+    // Use a smaller font for edge weights
+    QFont baseFont = painter.font();
+    QFont weightFont = baseFont;
+    weightFont.setPointSizeF(weightFont.pointSizeF() - 2.0);
+    painter.setFont(weightFont);
+
     // Draw each edge
-    for (uint32_t i = 0; i < matrice->getSize(); i++)
+    for (const Edge& edge : edges)
     {
-        for (uint32_t j = 0; j < matrice->getSize(); j++)
-        {
-            // Skip if no edge
-            if (matrice->getEdge(i, j) == 0) continue;
-
-            // Compute the positions of the start and end of the edge (offset by the center of the widget)
-            QPointF from = nodes[i].position + QPointF(centerX, centerY) + graphOffset;
-            QPointF to = nodes[j].position + QPointF(centerX, centerY) + graphOffset;
-
-            // Create the line (and skip if its length is 0)
-            QLineF line(from, to);
-            if (line.length() == 0) continue;
-
-            // Offset the line to avoid overlapping the nodes
-            double offset = NODE_SIZE * zoom / 2.0;
-            line.setP1(line.pointAt(offset / line.length()));
-            line.setP2(line.pointAt(1.0 - offset / line.length()));
-
-            // Draw the line
-            painter.drawLine(line);
-
-            // Draw the arrow if the graph is directed
-            if (matrice->isOriented()) {
-                double angle = std::atan2(-line.dy(), line.dx());
-                QPointF arrowP1 = line.p2() - QPointF(
-                    std::cos(angle + M_PI / 6) * ARROW_SIZE,
-                    -std::sin(angle + M_PI / 6) * ARROW_SIZE
-                );
-                QPointF arrowP2 = line.p2() - QPointF(
-                    std::cos(angle - M_PI / 6) * ARROW_SIZE,
-                    -std::sin(angle - M_PI / 6) * ARROW_SIZE
-                );
-                QPolygonF arrowHead;
-                arrowHead << line.p2() << arrowP1 << arrowP2;
-                painter.setBrush(Qt::white);
-                painter.drawPolygon(arrowHead);
-                painter.setBrush(Qt::NoBrush);
-            }
+        // Create the line (and skip if its length is 0, or if it cannot be seen)
+        QLineF line(nodes[edge.from].position, nodes[edge.to].position);
+        if (line.length() == 0 || !isVisible(line)) continue;
+
+        // Offset the line to avoid overlapping the nodes
+        double offset = NODE_SIZE / 2.0;
+        line.setP1(line.pointAt(offset / line.length()));
+        line.setP2(line.pointAt(1.0 - offset / line.length()));
+
+        // Draw the line
+        painter.drawLine(line);
+
+        // Draw the arrow if the graph is directed
+        if (matrice->isOriented()) {
+            painter.setBrush(Qt::white);
+            painter.drawPolygon(arrowHead(line));
+            painter.setBrush(Qt::NoBrush);
+        }
+
+        // Draw the edge weight near the middle of the edge, offset perpendicularly
+        if (matrice->isWeighted()) {
+            QString weight = QString::number(edge.weight);
 
-            // Draw the edge weight near the middle of the edge, offset perpendicularly
-            if (matrice->isWeighted()) {
-                QString weight = QString::number(matrice->getEdge(i, j));
-                // Use a smaller font for edge weights
-                QFont f = painter.font();
-                f.setPointSizeF(f.pointSizeF() - 2.0);
-                painter.setFont(f);
-
-                // Retrieve the middle of the line
-                QPointF mid = line.pointAt(0.5);
-
-                // Compute the perpendicular vector to the line
-                double lx = line.dx();
-                double ly = line.dy();
-                double llen = std::hypot(lx, ly);
-                QPointF perp(0, 0);
-                if (llen != 0) {
-                    perp = QPointF(-ly / llen, lx / llen);
-                }
-
-                // Offset the label a little so it does not overlap the edge
-                const double TEXT_OFFSET = 10.0;
-                QPointF textPos = mid + perp * TEXT_OFFSET;
-
-                // Draw text centered on that position
-                QRectF textRect(textPos.x() - 20.0, textPos.y() - 10.0, 40.0, 20.0);
-                painter.drawText(textRect, Qt::AlignCenter, weight);
-
-                // Restore the base font
-                f.setPointSizeF(f.pointSizeF() + 2.0);
-                painter.setFont(f);
+            // Retrieve the middle of the line
+            QPointF mid = line.pointAt(0.5);
+
+            // Compute the perpendicular vector to the line
+            double lx = line.dx();
+            double ly = line.dy();
+            double llen = std::hypot(lx, ly);
+            QPointF perp(0, 0);
+            if (llen != 0) {
+                perp = QPointF(-ly / llen, lx / llen);
             }
+
+            // Offset the label a little so it does not overlap the edge
+            const double TEXT_OFFSET = 10.0;
+            QPointF textPos = mid + perp * TEXT_OFFSET;
+
+            // Draw text centered on that position
+            QRectF textRect(textPos.x() - 20.0, textPos.y() - 10.0, 40.0, 20.0);
+            painter.drawText(textRect, Qt::AlignCenter, weight);
         }
     }
 
+    // Restore the base font
+    painter.setFont(baseFont);
+
+    // Draw the selected route over the other edges (always with arrows, as a route has a direction)
+    QPen routePen(QColor(255, 200, 0));
+    routePen.setWidth(ROUTE_EDGE_SIZE);
+    routePen.setCosmetic(true);
+    for (size_t i = 0; i + 1 < route.size(); i++)
+    {
+        // Compute the line of the edge, offset to avoid overlapping the nodes
+        QLineF line(nodes[route[i]].position, nodes[route[i + 1]].position);
+        if (line.length() == 0) continue;
+        double offset = NODE_SIZE / 2.0;
+        line.setP1(line.pointAt(offset / line.length()));
+        line.setP2(line.pointAt(1.0 - offset / line.length()));
+
+        // Draw the line and its arrow
+        painter.setPen(routePen);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawLine(line);
+        painter.setBrush(routePen.color());
+        painter.drawPolygon(arrowHead(line));
+    }
+
+    // Draw the shortest paths tree of the source over the other edges (each node is linked to its parent)
+    for (uint32_t i = 0; i < sourcePaths.parents.size(); i++)
+    {
+        // Skip the source and the unreachable nodes
+        uint32_t parent = sourcePaths.parents[i];
+        if (parent == UINT32_MAX) continue;
+
+        // Compute the line of the edge, offset to avoid overlapping the nodes
+        QLineF line(nodes[parent].position, nodes[i].position);
+        if (line.length() == 0 || !isVisible(line)) continue;
+        double offset = NODE_SIZE / 2.0;
+        line.setP1(line.pointAt(offset / line.length()));
+        line.setP2(line.pointAt(1.0 - offset / line.length()));
+
+        // Draw the line and its arrow
+        painter.setPen(routePen);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawLine(line);
+        painter.setBrush(routePen.color());
+        painter.drawPolygon(arrowHead(line));
+    }
+
     // Draw each node
     for (uint32_t i = 0; i < matrice->getSize(); i++)
     {
-        // Compute the position of the node (offset by the center of the widget)
+        // Skip the node if it cannot be seen
         const auto &node = nodes[i];
-        QPointF pos = node.position + QPointF(centerX, centerY) + graphOffset;
+        QPointF pos = node.position;
+        if (!visible.contains(pos)) continue;
 
-        // Draw the node circle
+        // Draw the node circle (circled if it is part of the selected route)
+        bool onRoute = i == routeOrigin || i == source || std::find(route.begin(), route.end(), i) != route.end();
         painter.setBrush(*node.color);
-        painter.setPen(Qt::NoPen);
-        painter.drawEllipse(pos, NODE_SIZE * zoom / 2.0, NODE_SIZE * zoom/ 2.0);
+        painter.setPen(onRoute ? routePen : QPen(Qt::NoPen));
+        painter.drawEllipse(pos, NODE_SIZE / 2.0, NODE_SIZE / 2.0);
 
         // Draw the node name (in white, centered)
         painter.setPen(Qt::white);
         painter.setBrush(Qt::NoBrush);
         QString name = QString::fromStdString(matrice->getName(i));
         QRectF textRect(
-            pos.x() - NODE_SIZE * zoom, pos.y() - NODE_SIZE * zoom / 2.0,
-            NODE_SIZE * zoom * 2, NODE_SIZE * zoom
+            pos.x() - NODE_SIZE, pos.y() - NODE_SIZE / 2.0,
+            NODE_SIZE * 2, NODE_SIZE
         );
         painter.drawText(textRect, Qt::AlignCenter, name);
+
+        // Draw the distance from the source under the node (in the color of the tree), if there is a path
+        if (!sourcePaths.distances.empty() && sourcePaths.distances[i] != INT64_MAX) {
+            painter.setPen(routePen.color());
+            QRectF distanceRect(
+                pos.x() - NODE_SIZE, pos.y() + NODE_SIZE / 2.0,
+                NODE_SIZE * 2, 20.0
+            );
+            painter.drawText(distanceRect, Qt::AlignHCenter | Qt::AlignTop, QString::number(sourcePaths.distances[i]));
+        }
     }
 }
 
 void GraphWidget::mousePressEvent(QMouseEvent* event)
 {
+    // Retrieve the position of the mouse in the graph
+    QPointF mousePos = toGraph(event->pos());
+
+    // Select the route with right clicks (outside of any node, the route is cleared)
+    if (event->button() == Qt::RightButton && nextHops != nullptr) {
+        selectRouteNode(findNode(mousePos));
+        update();
+        return;
+    }
+
+    // Select the source of the distances with right clicks (outside of any node, the distances are cleared)
+    if (event->button() == Qt::RightButton && sourceSelection) {
+        selectSource(findNode(mousePos));
+        update();
+        return;
+    }
+
     // Skip if not a left click
     if (event->button() != Qt::LeftButton) return;
 
     // Set the cursor to a closed hand
     setCursor(Qt::ClosedHandCursor);
 
-    // Retrieve the adjusted position of the mouse
-    int centerX = width() / 2;
-    int centerY = height() / 2;
-    QPointF mousePos = event->pos() - QPointF(centerX, centerY) - graphOffset;  // Graph coordinates are based on (0;0) and not on the center of the widget
-
-    // Check if a node is under the mouse
-    for (uint32_t i = 0; i < matrice->getSize(); i++) {
-        QPointF nodePos = nodes[i].position;
-        double distance = std::hypot(mousePos.x() - nodePos.x(), mousePos.y() - nodePos.y());  // Distance between the mouse and the node center
-
-        // If the distance is less than the node radius, the node and its offset are stored
-        if (distance <= NODE_SIZE * zoom / 2.0) {
-            targetNode = &nodes[i];
-            offset = mousePos - nodePos;
-            return;
-        }
+    // If a node is under the mouse, the node and its offset are stored (the layout is stopped, so that it does not move the nodes anymore)
+    uint32_t node = findNode(mousePos);
+    if (node != UINT32_MAX) {
+        stopLayout();
+        targetNode = &nodes[node];
+        offset = mousePos - nodes[node].position;
+        return;
     }
 
     // If no node was found, offset the entire graph
@@ -243,10 +335,7 @@ void GraphWidget::mouseMoveEvent(QMouseEvent* event)
 
     // Move the node to the mouse position
     if (targetNode) {
-        int centerX = width() / 2;
-        int centerY = height() / 2;
-        QPointF mousePos = event->pos() - QPointF(centerX, centerY) - graphOffset;  // Graph coordinates are based on (0;0) and not on the center of the widget
-        targetNode->position = mousePos - offset;
+        targetNode->position = toGraph(event->pos()) - offset;
         update();
     }
 
@@ -260,19 +349,10 @@ void GraphWidget::mouseMoveEvent(QMouseEvent* event)
 
 void GraphWidget::wheelEvent(QWheelEvent *event)
 {
-    // Zoom in or out based on the wheel delta
+    // Zoom in or out based on the wheel delta, on the mouse position
     int delta = event->angleDelta().y();
-    if (delta > 0) zoom *= ZOOM_MULTIPLIER;
-    else if (delta < 0)  zoom /= ZOOM_MULTIPLIER;
-
-    // Clamp the zoom level
-    if (zoom < static_cast<float>(MIN_ZOOM) / 100.0f) zoom = static_cast<float>(MIN_ZOOM) / 100.0f;
-    if (zoom > static_cast<float>(MAX_ZOOM) / 100.0f) zoom = static_cast<float>(MAX_ZOOM) / 100.0f;
-
-    // Recompute node positions and update the display
-    zoomSlider->setValue(static_cast<int>(zoom * 100));
-    computeNodes();
-    update();
+    if (delta > 0) setZoom(zoom * ZOOM_MULTIPLIER, event->position());
+    else if (delta < 0) setZoom(zoom / ZOOM_MULTIPLIER, event->position());
 }
 
 void GraphWidget::computeNodes()
@@ -282,8 +362,8 @@ void GraphWidget::computeNodes()
     double graphPerimeter = 0;
     double* clustersRadii = new double[nbClusters];
     for (uint32_t i = 0; i < nbClusters; i++) {
-        clustersRadii[i] = (NODE_SIZE * zoom + NODE_SPACING * zoom) * clusters[i].size() / M_PI / 2;
-        graphPerimeter += clustersRadii[i] * 2 + NODE_SPACING * zoom;
+        clustersRadii[i] = (NODE_SIZE + NODE_SPACING) * clusters[i].size() / M_PI / 2;
+        graphPerimeter += clustersRadii[i] * 2 + NODE_SPACING;
     }
     double graphRadius = graphPerimeter / M_PI / 2;
 
@@ -292,13 +372,13 @@ void GraphWidget::computeNodes()
     double offset = 0;
     for (uint32_t i = 0; i < nbClusters; i++) {
         // Compute the position of the center of the cluster
-        offset += clustersRadii[i] + NODE_SPACING * zoom / 2;
+        offset += clustersRadii[i] + NODE_SPACING / 2;
         double angle = 2 * M_PI * offset / graphPerimeter;
         QPointF clusterPos(
             graphRadius * cos(angle),
             graphRadius * sin(angle)
         );
-        offset += clustersRadii[i] + NODE_SPACING * zoom / 2;
+        offset += clustersRadii[i] + NODE_SPACING / 2;
 
         // Compute the position & color of each node in the cluster
         QColor* color = new QColor(QColor::fromHsv((i * 50) % 360, 192, 160));  // Offset by 50° allow for 36 distinct colors, with a good difference between each and a still good unity of colors
@@ -318,3 +398,184 @@ void GraphWidget::computeNodes()
     // Free the resources
     delete[] clustersRadii;
 }
+
+void GraphWidget::startLayout()
+{
+    // Start from the current positions of the nodes (the clusters on their circles)
+    std::vector<ForceLayout::Point> positions(matrice->getSize());
+    for (uint32_t i = 0; i < matrice->getSize(); i++) {
+        positions[i] = {nodes[i].position.x(), nodes[i].position.y()};
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    links.reserve(edges.size());
+    for (const Edge& edge : edges) links.push_back({edge.from, edge.to});
+    layout = new ForceLayout(positions, links, NODE_SIZE + NODE_SPACING);
+
+    // Start the layout thread, with an object to post the layout to (deleted when the thread stops)
+    layoutThread = new QThread(this);
+    layoutContext = new QObject();
+    layoutContext->moveToThread(layoutThread);
+    connect(layoutThread, &QThread::finished, layoutContext, &QObject::deleteLater);
+    layoutThread->start();
+
+    // Compute the iterations on the layout thread, and show their positions on the window thread (the updates still pending
+    // when the widget is destroyed are dropped with it)
+    QMetaObject::invokeMethod(layoutContext, [this]() {
+        auto send = [this](const std::vector<ForceLayout::Point>& positions) {
+            QMetaObject::invokeMethod(this, [this, positions]() {
+                applyLayout(positions);
+            }, Qt::QueuedConnection);
+        };
+
+        QElapsedTimer budget;
+        QElapsedTimer frame;
+        budget.start();
+        frame.start();
+        while (!layout->isConverged() && !layoutCancellation.isCancelled() && budget.elapsed() < LAYOUT_TIME_BUDGET) {
+            layout->step();
+            if (frame.elapsed() >= LAYOUT_FRAME_INTERVAL) {
+                send(layout->getPositions());
+                frame.restart();
+            }
+        }
+        send(layout->getPositions());
+    }, Qt::QueuedConnection);
+}
+
+void GraphWidget::stopLayout()
+{
+    layoutCancellation.cancel();
+}
+
+void GraphWidget::applyLayout(const std::vector<ForceLayout::Point>& positions)
+{
+    // Ignore the positions computed after the layout was stopped (ex. while a node is moved)
+    if (layoutCancellation.isCancelled()) return;
+
+    for (uint32_t i = 0; i < matrice->getSize(); i++) {
+        nodes[i].position = QPointF(positions[i].x, positions[i].y);
+    }
+    update();
+}
+
+QTransform GraphWidget::viewTransform() const
+{
+    return QTransform().translate(width() / 2 + graphOffset.x(), height() / 2 + graphOffset.y()).scale(zoom, zoom);
+}
+
+QPointF GraphWidget::toGraph(QPointF position) const
+{
+    return (position - QPointF(width() / 2, height() / 2) - graphOffset) / zoom;
+}
+
+void GraphWidget::setZoom(float zoom, QPointF anchor)
+{
+    // Clamp the zoom level
+    zoom = std::clamp(zoom, static_cast<float>(MIN_ZOOM) / 100.0f, static_cast<float>(MAX_ZOOM) / 100.0f);
+
+    // Move the graph so that the point under the anchor stays in place
+    QPointF anchored = toGraph(anchor);
+    this->zoom = zoom;
+    graphOffset = anchor - QPointF(width() / 2, height() / 2) - anchored * zoom;
+
+    // Update the slider (without zooming again) and the display: the nodes keep their positions, only the transform changes
+    QSignalBlocker blocker(zoomSlider);
+    zoomSlider->setValue(static_cast<int>(std::round(zoom * 100)));
+    update();
+}
+
+uint32_t GraphWidget::findNode(QPointF position) const
+{
+    for (uint32_t i = 0; i < matrice->getSize(); i++) {
+        QPointF nodePos = nodes[i].position;
+        double distance = std::hypot(position.x() - nodePos.x(), position.y() - nodePos.y());  // Distance between the position and the node center
+
+        // If the distance is less than the node radius, the position is on the node
+        if (distance <= NODE_SIZE / 2.0) return i;
+    }
+    return UINT32_MAX;
+}
+
+QPolygonF GraphWidget::arrowHead(const QLineF& line) const
+{
+    double angle = std::atan2(-line.dy(), line.dx());
+    QPointF arrowP1 = line.p2() - QPointF(
+        std::cos(angle + M_PI / 6) * ARROW_SIZE,
+        -std::sin(angle + M_PI / 6) * ARROW_SIZE
+    );
+    QPointF arrowP2 = line.p2() - QPointF(
+        std::cos(angle - M_PI / 6) * ARROW_SIZE,
+        -std::sin(angle - M_PI / 6) * ARROW_SIZE
+    );
+    QPolygonF head;
+    head << line.p2() << arrowP1 << arrowP2;
+    return head;
+}
+
+void GraphWidget::selectRouteNode(uint32_t node)
+{
+    // Clear the route
+    if (node == UINT32_MAX) {
+        routeOrigin = UINT32_MAX;
+        route.clear();
+        routeLabel->setText("Right-click two nodes to highlight the shortest route between them.");
+        return;
+    }
+
+    // Select the origin of a new route
+    if (routeOrigin == UINT32_MAX) {
+        routeOrigin = node;
+        route.clear();
+        routeLabel->setText(QString("Route from %1: right-click the destination.").arg(QString::fromStdString(matrice->getName(node))));
+        return;
+    }
+
+    // Select the destination, and follow the next hops from the origin
+    QString origin = QString::fromStdString(matrice->getName(routeOrigin));
+    QString destination = QString::fromStdString(matrice->getName(node));
+    try {
+        route = nextHops->route(routeOrigin, node);
+        if (route.empty()) {
+            routeLabel->setText(QString("No route from %1 to %2.").arg(origin, destination));
+        } else {
+            QStringList names;
+            for (uint32_t id : route) names << QString::fromStdString(matrice->getName(id));
+            routeLabel->setText(QString("Route: %1 (length %2)").arg(names.join(" → ")).arg(distances->getEdge(routeOrigin, node)));
+        }
+    } catch (const std::runtime_error& e) {
+        route.clear();
+        routeLabel->setText(QString("No route from %1 to %2: %3").arg(origin, destination, e.what()));
+    }
+    routeOrigin = UINT32_MAX;
+}
+
+void GraphWidget::selectSource(uint32_t node)
+{
+    // Clear the distances
+    source = UINT32_MAX;
+    sourcePaths = Matrice::SingleSourcePaths();
+    if (node == UINT32_MAX) {
+        routeLabel->setText("Right-click a node to show the distances from it.");
+    } else {
+        routeLabel->setText(QString("Computing the distances from %1...").arg(QString::fromStdString(matrice->getName(node))));
+    }
+
+    // Ask for the shortest paths from the node only (they may take a while with negative weights, see `Matrice::bellmanFord`)
+    emit sourceSelected(node);
+}
+
+void GraphWidget::showSourcePaths(uint32_t node, const Matrice::SingleSourcePaths& paths, const QString& error)
+{
+    QString name = QString::fromStdString(matrice->getName(node));
+    if (!error.isEmpty()) {
+        routeLabel->setText(QString("No distances from %1: %2").arg(name, error));
+        return;
+    }
+
+    sourcePaths = paths;
+    source = node;
+    uint32_t reachable = 0;
+    for (int64_t distance : sourcePaths.distances) reachable += distance != INT64_MAX;
+    routeLabel->setText(QString("Distances from %1 (%2 reachable nodes out of %3).").arg(name).arg(reachable).arg(matrice->getSize()));
+    update();
+}
@@ -1,16 +1,24 @@
 #ifndef GRAPHWIDGET_H
 #define GRAPHWIDGET_H
 
+#include "forcelayout.h"
 #include "matrice.h"
+#include "progress.h"
 
+#include <QLabel>
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QPainter>
 #include <QSlider>
+#include <QThread>
+#include <QTransform>
 #include <QWidget>
 
+#include <vector>
+
 #define ARROW_SIZE 10
 #define EDGE_SIZE 2
+#define ROUTE_EDGE_SIZE 4
 #define NODE_SIZE 40
 #define NODE_SPACING 100
 
@@ -18,8 +26,12 @@
 #define MAX_ZOOM 300  // Maximum zoom level (in percent)
 #define ZOOM_MULTIPLIER 1.1f  // Multiplier for each wheel step
 
+#define LAYOUT_TIME_BUDGET 5000  // Maximum duration of the force-directed layout of a graph (in milliseconds)
+#define LAYOUT_FRAME_INTERVAL 40  // Minimum time between two updates of the positions while the layout runs (in milliseconds, 25 per second)
+
 /**
- * @brief A widget to display a Graph
+ * @brief A widget to display a Graph. Its nodes are first placed on a circle per cluster, then moved by a force-directed layout
+ * (see `ForceLayout`) running on its own thread, which shows the positions as they settle
  */
 class GraphWidget : public QWidget
 {
@@ -29,12 +41,14 @@ public:
     /**
      * @brief Construct a new GraphWidget object
      * @param data The matrice representing the graph
+     * @param clusters The clusters of the graph (see `Matrice::stronglyConnectedComponents`), each laid out on its own circle
+     * before the force-directed layout starts
      * @param parent The parent widget
      */
-    explicit GraphWidget(const Matrice* data, QWidget* parent = nullptr);
+    GraphWidget(const Matrice* data, const std::vector<std::vector<uint32_t>>& clusters, QWidget* parent = nullptr);
 
     /**
-     * @brief Destroy the GraphWidget object
+     * @brief Destroy the GraphWidget object (stopping its layout first)
      */
     ~GraphWidget() override;
 
@@ -44,6 +58,35 @@ public:
      */
     void forScreenshot(bool screenshot);
 
+    /**
+     * @brief Allow selecting routes: right-clicking two nodes highlights the shortest route between them
+     * @param distances The shortest path distances of the graph (not owned, they must outlive the widget)
+     * @param nextHops The next hops of the shortest paths, see `Matrice::floydWarshall` (not owned, they must outlive the widget)
+     */
+    void setRoutes(const Matrice* distances, const Matrice* nextHops);
+
+    /**
+     * @brief Allow selecting a source: right-clicking a node shows the distances from it and its shortest paths tree
+     * (only the paths from this node are computed, see `Matrice::shortestPathsFrom`, by the receiver of `sourceSelected`)
+     */
+    void setSourceSelection();
+
+    /**
+     * @brief Show the distances from the selected source and its shortest paths tree, once they are computed
+     * @param node The index of the source
+     * @param paths The shortest paths from the source (empty if there is an error)
+     * @param error Why there are no shortest paths from the source (ex. a negative cycle), or an empty string
+     */
+    void showSourcePaths(uint32_t node, const Matrice::SingleSourcePaths& paths, const QString& error);
+
+signals:
+    /**
+     * @brief Emitted when a source is selected, for the shortest paths from it to be computed (the graph stays usable meanwhile)
+     * and shown with `showSourcePaths`
+     * @param node The index of the source, or UINT32_MAX if the distances were cleared
+     */
+    void sourceSelected(uint32_t node);
+
 protected:
     /**
      * @brief Paint event handler
@@ -52,7 +95,7 @@ protected:
     void paintEvent(QPaintEvent* event) override;
 
     /**
-     * @brief Mouse down event handler, to allow moving nodes
+     * @brief Mouse down event handler, to allow moving nodes (left button, which stops the layout) and selecting routes or sources (right button)
      * @param event The mouse event
      */
     void mousePressEvent(QMouseEvent* event) override;
@@ -81,7 +124,7 @@ private:
      */
     struct Node {
         /**
-         * @brief The position of the node
+         * @brief The position of the node, in graph coordinates (independent of the zoom and of the offset of the graph)
          */
         QPointF position;
 
@@ -92,9 +135,82 @@ private:
     };
 
     /**
-     * @brief Compute the positions and colors of the nodes
+     * @brief Stores an edge of the graph, to draw it without walking the whole matrice
+     */
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        int64_t weight;
+    };
+
+    /**
+     * @brief Compute the positions (in graph coordinates) and colors of the nodes, once: the zoom and the offset of the graph
+     * are only applied when painting (see `viewTransform`), so that they keep the nodes moved by the user
      */
     void computeNodes();
+
+    /**
+     * @brief Start the force-directed layout on its thread, from the current positions of the nodes: it runs until it is done,
+     * stopped (see `stopLayout`) or after LAYOUT_TIME_BUDGET milliseconds, sending the positions at most once per LAYOUT_FRAME_INTERVAL
+     */
+    void startLayout();
+
+    /**
+     * @brief Stop the force-directed layout, keeping the positions already shown (the layout ends its current iteration on its thread)
+     */
+    void stopLayout();
+
+    /**
+     * @brief Show positions computed by the force-directed layout (ignored if it was stopped since)
+     * @param positions The position of each node, in graph coordinates
+     */
+    void applyLayout(const std::vector<ForceLayout::Point>& positions);
+
+    /**
+     * @brief Get the transform from graph coordinates to widget coordinates (the graph is centered on the widget, then moved and zoomed)
+     * @return The transform
+     */
+    QTransform viewTransform() const;
+
+    /**
+     * @brief Convert a position of the widget to graph coordinates
+     * @param position The position, in widget coordinates
+     * @return The position, in graph coordinates
+     */
+    QPointF toGraph(QPointF position) const;
+
+    /**
+     * @brief Change the zoom level (clamped between MIN_ZOOM and MAX_ZOOM), keeping the point of the graph under the anchor in place
+     * @param zoom The new zoom level
+     * @param anchor The position which does not move, in widget coordinates
+     */
+    void setZoom(float zoom, QPointF anchor);
+
+    /**
+     * @brief Find the node under a position
+     * @param position The position, in graph coordinates
+     * @return The index of the node, or UINT32_MAX if there is no node at this position
+     */
+    uint32_t findNode(QPointF position) const;
+
+    /**
+     * @brief Compute the arrow head of an edge
+     * @param line The line of the edge (already offset to not overlap the nodes)
+     * @return The triangle of the arrow head, at the end of the line
+     */
+    QPolygonF arrowHead(const QLineF& line) const;
+
+    /**
+     * @brief Select a node of the route: the origin if none is selected yet, the destination otherwise
+     * @param node The index of the node, or UINT32_MAX to clear the route
+     */
+    void selectRouteNode(uint32_t node);
+
+    /**
+     * @brief Select the source of the displayed distances, and ask for the shortest paths from it (see `sourceSelected`)
+     * @param node The index of the node, or UINT32_MAX to clear the distances
+     */
+    void selectSource(uint32_t node);
     
     /**
      * @brief The matrice representing the graph
@@ -116,13 +232,38 @@ private:
      */
     Node* nodes;
 
+    /**
+     * @brief The edges of the graph (the non-zero cells of the matrice), listed once
+     */
+    std::vector<Edge> edges;
+
+    /**
+     * @brief The force-directed layout of the nodes (only used on the layout thread)
+     */
+    ForceLayout* layout = nullptr;
+
+    /**
+     * @brief The thread running the force-directed layout
+     */
+    QThread* layoutThread = nullptr;
+
+    /**
+     * @brief An object living in the layout thread, to which the layout is posted
+     */
+    QObject* layoutContext = nullptr;
+
+    /**
+     * @brief The token stopping the force-directed layout
+     */
+    CancellationToken layoutCancellation;
+
     /**
     * @brief A pointer to the node being moved, or nullptr if no node is being moved
     */
    Node* targetNode = nullptr;
 
     /**
-     * @brief The offset between the mouse position and the center of the node being moved
+     * @brief The offset between the mouse position and the center of the node being moved (in graph coordinates)
      */
    QPointF offset;
 
@@ -132,7 +273,7 @@ private:
    float zoom = 1.0f;
 
     /**
-     * @brief The offset of the graph (to allow moving the entire graph)
+     * @brief The offset of the graph, in widget coordinates (to allow moving the entire graph)
      */
    QPointF graphOffset = QPointF(0, 0);
 
@@ -145,6 +286,46 @@ private:
      * @brief The starting position of the mouse when moving the graph
      */
    QPointF mousePosStart;
+
+    /**
+     * @brief The shortest path distances, or nullptr if routes cannot be selected
+     */
+    const Matrice* distances = nullptr;
+
+    /**
+     * @brief The next hops of the shortest paths, or nullptr if routes cannot be selected
+     */
+    const Matrice* nextHops = nullptr;
+
+    /**
+     * @brief The origin of the route being selected, or UINT32_MAX if no route is being selected
+     */
+    uint32_t routeOrigin = UINT32_MAX;
+
+    /**
+     * @brief The nodes of the highlighted route (empty if there is none)
+     */
+    std::vector<uint32_t> route;
+
+    /**
+     * @brief Whether a source can be selected, to display the distances from it
+     */
+    bool sourceSelection = false;
+
+    /**
+     * @brief The source of the displayed distances, or UINT32_MAX if there is none
+     */
+    uint32_t source = UINT32_MAX;
+
+    /**
+     * @brief The shortest paths from the source (empty if there is none)
+     */
+    Matrice::SingleSourcePaths sourcePaths;
+
+    /**
+     * @brief The label describing the selected route or source
+     */
+    QLabel* routeLabel;
 };
 
 #endif // GRAPHWIDGET_H
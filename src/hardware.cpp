@@ -0,0 +1,104 @@
+#include "hardware.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <vector>
+#elif defined(__APPLE__)
+#include <sys/sysctl.h>
+#else
+#include <unistd.h>
+#endif
+
+size_t cacheSize(uint32_t level)
+{
+#if defined(_WIN32)
+    // Find the first data (or unified) cache of the given level
+    DWORD bytes = 0;
+    GetLogicalProcessorInformation(nullptr, &bytes);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(bytes / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (infos.empty() || !GetLogicalProcessorInformation(infos.data(), &bytes)) return 0;
+    for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info : infos) {
+        if (info.Relationship == RelationCache && info.Cache.Level == level && info.Cache.Type != CacheInstruction) {
+            return info.Cache.Size;
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    const char* names[] = {"hw.l1dcachesize", "hw.l2cachesize", "hw.l3cachesize"};
+    if (level < 1 || level > 3) return 0;
+    uint64_t size = 0;
+    size_t length = sizeof(size);
+    return sysctlbyname(names[level - 1], &size, &length, nullptr, 0) == 0 ? static_cast<size_t>(size) : 0;
+#elif defined(_SC_LEVEL1_DCACHE_SIZE)
+    int names[] = {_SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE};
+    if (level < 1 || level > 3) return 0;
+    long size = sysconf(names[level - 1]);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+#else
+    (void)level;
+    return 0;
+#endif
+}
+
+/*******
+| SIMD |
+*******/
+
+namespace {
+
+/**
+ * @brief Detect the newest SIMD level supported by the processor and the operating system.
+ */
+SimdLevel detectSimdLevel()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // GCC and Clang check both the processor and the operating system (saved vector registers)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+    return SimdLevel::Scalar;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    // Check the processor features, then that the operating system saves the vector registers (XCR0)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse42 = (info[2] & (1 << 20)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!sse42) return SimdLevel::Scalar;
+    if (!osxsave) return SimdLevel::SSE42;
+    unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    bool avx512 = (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0 && (xcr0 & 0xE6) == 0xE6;
+    if (avx512) return SimdLevel::AVX512;
+    if (avx2) return SimdLevel::AVX2;
+    return SimdLevel::SSE42;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+}
+
+SimdLevel simdLevel()
+{
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::SSE42:  return "SSE4.2";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default:                return "Scalar";
+    }
+}
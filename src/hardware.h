@@ -0,0 +1,56 @@
+#ifndef HARDWARE_H
+#define HARDWARE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define DEFAULT_L2_CACHE_SIZE (256 * 1024)  // Cache size assumed when it cannot be detected (smallest common L2 size)
+
+// The SIMD kernels are only compiled for x86 processors (the others use the scalar kernels)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86
+#endif
+
+// Each SIMD kernel is compiled for its own instruction set, whatever the flags of the rest of the application,
+// and is only called when the processor supports it (MSVC always allows the intrinsics, so no attribute is needed)
+#if defined(__GNUC__)
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define TARGET_SSE42
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+/**
+ * @brief The SIMD instruction sets used by the vectorized kernels, from the oldest to the newest (each one includes the previous ones).
+ */
+enum class SimdLevel : uint8_t {
+    Scalar,  // No SIMD instruction (or not an x86 processor)
+    SSE42,   // SSE up to 4.2 (128-bit vectors)
+    AVX2,    // AVX2 (256-bit vectors)
+    AVX512,  // AVX-512 F and BW (512-bit vectors, with masks)
+};
+
+/**
+ * @brief Get the newest SIMD instruction set supported by the processor and the operating system (detected on first call).
+ * @return The SIMD level.
+ */
+SimdLevel simdLevel();
+
+/**
+ * @brief Get the name of a SIMD level (ex. "AVX2").
+ * @param level The SIMD level.
+ * @return The name of the level.
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief Get the size of a data cache of the processor (per core for private caches), as reported by the operating system.
+ * @param level The level of the cache (1 for L1, 2 for L2, ...).
+ * @return The size of the cache in bytes, or 0 if it cannot be detected.
+ */
+size_t cacheSize(uint32_t level);
+
+#endif // HARDWARE_H
@@ -1,9 +1,29 @@
+#include "benchmark.h"
 #include "mainwindow.h"
 
 #include <QApplication>
 
+#include <cstring>
+#include <iostream>
+
 int main(int argc, char *argv[])
 {
+    // Convert a text matrix to the binary format, without opening the window: `graphs --convert <input.txt> <output.gbin>`
+    if (argc == 4 && std::strcmp(argv[1], "--convert") == 0) {
+        try {
+            Matrice(argv[2]).save(argv[3]);
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Run a benchmark, without opening the window: `graphs --benchmark <name> [arguments...]`
+    if (argc >= 2 && std::strcmp(argv[1], "--benchmark") == 0) {
+        return runBenchmark(argc, argv);
+    }
+
     QApplication a(argc, argv);
     MainWindow w;
     w.show();
@@ -1,16 +1,23 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+#include "binaryformat.h"
 #include "errorwidget.h"
 #include "graphwidget.h"
 #include "matricewidget.h"
 
 #include <QFileDialog>
+#include <QMessageBox>
+
+#include <optional>
+#include <stdexcept>
 
 MainWindow::MainWindow(QWidget* parent):
     QMainWindow(parent),
     ui(new Ui::MainWindow),
-    currentMatrice(nullptr)
+    currentMatrice(nullptr),
+    displayedMatrice(nullptr),
+    displayId(0)
 {
     ui->setupUi(this);
 
@@ -21,34 +28,225 @@ MainWindow::MainWindow(QWidget* parent):
     // Set placeholder widget
     displayedWidget = new ErrorWidget("Please import a matrice file with \"File >> Import...\", or with \"Ctrl+O\".", "No Matrice", this);
     setCentralWidget(displayedWidget);
+
+    // Start the analysis thread, with an object to post the analyses to (deleted when the thread stops)
+    analysisThread = new QThread(this);
+    analysisContext = new QObject();
+    analysisContext->moveToThread(analysisThread);
+    connect(analysisThread, &QThread::finished, analysisContext, &QObject::deleteLater);
+    analysisThread->start();
+
+    // Create the progress indicator of the analyses and their cancel button
+    analysisProgress = new QProgressBar(this);
+    analysisProgress->setMaximumWidth(150);
+    statusBar()->addPermanentWidget(analysisProgress);
+    analysisCancelButton = new QToolButton(this);
+    analysisCancelButton->setDefaultAction(ui->actionCancel);
+    statusBar()->addPermanentWidget(analysisCancelButton);
+    setAnalysisRunning(false);
 }
 
 MainWindow::~MainWindow()
 {
+    // Stop the analysis thread (once the running analysis stops, skipping the other ones), before freeing what the analyses use
+    analysisRequest++;
+    analysisCancellation.cancel();
+    analysisThread->quit();
+    analysisThread->wait();
+
     delete ui;
 
-    if (displayedMatrice != currentMatrice) {
-        delete displayedMatrice;
-    }
+    // The displayed matrice is either the current one or owned by the analysis cache
+    analysis.reset(nullptr);
     delete currentMatrice;
 }
 
+/***********
+| Analyses |
+***********/
+
+void MainWindow::showAnalysisMessage(const QString& message)
+{
+    statusBar()->showMessage(QString("%1 (analysis cache: %2 hits, %3 misses)").arg(message).arg(analysisHits).arg(analysisMisses));
+}
+
+template<typename Compute, typename Display>
+void MainWindow::runAnalysis(uint8_t view, const QString& description, Compute compute, Display display)
+{
+    // Stop the running analysis (its result would be discarded), and show the progress of this one
+    uint64_t request = ++analysisRequest;
+    analysisCancellation.cancel();
+    analysisDescription = description;
+    setAnalysisRunning(true);
+    statusBar()->showMessage(QString("Computing %1...").arg(description));
+
+    // Compute the result on the analysis thread, after the analyses requested before
+    QMetaObject::invokeMethod(analysisContext, [this, request, view, compute, display]() {
+        // Skip the analysis if it was discarded before it started. The token is lowered first, so that a discard after the check raises it again
+        analysisCancellation.reset();
+        if (request != analysisRequest) return;
+
+        // Show the progress of its algorithms on the window thread, as long as it is not discarded
+        ProgressHooks hooks;
+        hooks.cancellation = &analysisCancellation;
+        hooks.progress = [this, request](uint64_t done, uint64_t total) {
+            QMetaObject::invokeMethod(this, [this, request, done, total]() {
+                if (request == analysisRequest) showAnalysisProgress(done, total);
+            }, Qt::QueuedConnection);
+        };
+
+        using Result = decltype(compute(analysis, &hooks));
+        std::optional<Result> result;
+        QString error;
+        try {
+            result = compute(analysis, &hooks);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        uint64_t hits = analysis.getHits();
+        uint64_t misses = analysis.getMisses();
+
+        // Display the result on the window thread, unless it was discarded in the meantime
+        QMetaObject::invokeMethod(this, [this, request, view, display, result, error, hits, misses]() {
+            if (request != analysisRequest) return;
+            setAnalysisRunning(false);
+            statusBar()->clearMessage();
+            analysisHits = hits;
+            analysisMisses = misses;
+            displayId = view;
+
+            try {
+                if (!result) throw std::runtime_error(error.toStdString());
+                display(*result);
+
+            // If there is an error, display the error widget
+            } catch (const std::exception& e) {
+                displayedMatrice = nullptr;
+                displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
+                setCentralWidget(displayedWidget);
+            }
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void MainWindow::setAnalysisRunning(bool running)
+{
+    // The progress is unknown until the first algorithm reports it, so the indicator starts as a busy indicator
+    analysisProgress->setRange(0, 0);
+    analysisProgress->setVisible(running);
+    analysisCancelButton->setVisible(running);
+    ui->actionCancel->setEnabled(running);
+    analysisDone = 0;
+}
+
+void MainWindow::showAnalysisProgress(uint64_t done, uint64_t total)
+{
+    // Each algorithm of the analysis reports its own progress, from 0 (ex. the clusters of the minimum spanning tree, once it is computed)
+    if (done == 0 || done < analysisDone || analysisProgress->maximum() == 0) analysisTimer.start();
+    analysisDone = done;
+    analysisProgress->setRange(0, PROGRESS_STEPS);
+    analysisProgress->setValue(total == 0 ? PROGRESS_STEPS : static_cast<int>(done * PROGRESS_STEPS / total));
+
+    // Estimate the time left from the speed of the algorithm so far
+    QString message = QString("Computing %1... %2%").arg(analysisDescription).arg(total == 0 ? 100 : done * 100 / total);
+    if (done > 0 && done < total) {
+        double left = analysisTimer.elapsed() / 1000.0 * (total - done) / done;
+        message += QString(" (about %1 s left)").arg(left, 0, 'f', left < 10 ? 1 : 0);
+    }
+    statusBar()->showMessage(message);
+}
+
+void MainWindow::discardAnalysis()
+{
+    analysisRequest++;
+    analysisCancellation.cancel();
+    setAnalysisRunning(false);
+}
+
+void MainWindow::showDistancesFrom(GraphWidget* graphWidget, uint32_t node)
+{
+    // Stop computing the distances from the previous source once they are cleared
+    if (node == UINT32_MAX) {
+        discardAnalysis();
+        statusBar()->clearMessage();
+        return;
+    }
+
+    // Compute the shortest paths from the source only, the errors (ex. a negative cycle) being shown by the view, which stays displayed
+    struct Result {
+        Matrice::SingleSourcePaths paths;
+        QString error;
+    };
+    QString name = QString::fromStdString(currentMatrice->getName(node));
+    runAnalysis(5, QString("the distances from %1").arg(name), [node](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        try {
+            result.paths = analysis.getGraph()->shortestPathsFrom(node, hooks);
+        } catch (const CancelledError&) {
+            throw;  // The analysis was discarded: its result is not displayed
+        } catch (const std::runtime_error& e) {
+            result.error = e.what();
+        }
+        return result;
+    }, [graphWidget, node](const Result& result) {
+        graphWidget->showSourcePaths(node, result.paths, result.error);
+    });
+}
+
+/**********
+| Actions |
+**********/
+
 void MainWindow::on_actionImport_triggered()
 {
     // Prompt the user to select a file
-    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Matrice File"), "", tr("Matrice Files (*.txt);;All Files (*)"));
+    QString fileName = QFileDialog::getOpenFileName(this, tr("Open Matrice File"), "", tr("Matrice Files (*.txt *" BINARY_EXTENSION ");;All Files (*)"));
     if (fileName.isEmpty()) {
         return;
     }
 
-    // Free the resources and load the new matrice
-    delete currentMatrice;
-    currentMatrice = new Matrice(fileName.toStdString());
+    // Discard the running analysis, and stop displaying the previous matrice (it is freed below)
+    discardAnalysis();
+    statusBar()->clearMessage();
+    displayedMatrice = nullptr;
+    displayedWidget = new ErrorWidget("Loading the matrice...", "Please Wait", this);
+    setCentralWidget(displayedWidget);
+
+    // Load the new matrice
+    const Matrice* previousMatrice = currentMatrice;
+    currentMatrice = nullptr;
+    QString error;
+    try {
+        Matrice* matrice = new Matrice(fileName.toStdString());
+
+        // Compute its lazy properties right away, as the views read them on this thread while the analyses run on theirs
+        matrice->isOriented();
+        matrice->isWeighted();
+        currentMatrice = matrice;
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    // Free the previous matrice and its results on the analysis thread, once the analyses still using them end
+    const Matrice* newMatrice = currentMatrice;
+    QMetaObject::invokeMethod(analysisContext, [this, previousMatrice, newMatrice]() {
+        analysis.reset(newMatrice);
+        delete previousMatrice;
+    }, Qt::QueuedConnection);
+
+    // If the file is invalid, display the error widget
+    if (currentMatrice == nullptr) {
+        displayedWidget = new ErrorWidget(error, "Invalid File", this);
+        setCentralWidget(displayedWidget);
+        return;
+    }
 
     // Update the displayed widget to show the new matrice as a graph
     if      (displayId ==   1) on_actionBasicGraphView_triggered();
     else if (displayId ==   2) on_actionPrimGraphView_triggered();
+    else if (displayId ==   3) on_actionFloydWarshallGraphView_triggered();
     else if (displayId ==   4) on_actionClustersGraphView_triggered();
+    else if (displayId ==   5) on_actionDistancesGraphView_triggered();
     else if (displayId == 101) on_actionBasicMatriceView_triggered();
     else if (displayId == 102) on_actionPrimMatriceView_triggered();
     else if (displayId == 103) on_actionFloydWarshallMatriceView_triggered();
@@ -63,21 +261,29 @@ void MainWindow::on_actionImport_triggered()
 
 void MainWindow::on_actionExport_triggered()
 {
-    // Ignore the action if there is no matrice loaded
-    if (currentMatrice == nullptr) return;
+    // Ignore the action if there is no matrice displayed (none loaded, or its view is still being computed)
+    if (displayedMatrice == nullptr) return;
 
     // Prepare the widget for screenshot
     if (displayId >= 1 && displayId <= 99)  // Graph view
         static_cast<GraphWidget*>(displayedWidget)->forScreenshot(true);
 
     // Prompt the user to select a file
-    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Image"), "", tr("PNG Image (*.png);;JPEG Image (*.jpg);;BMP Image (*.bmp);;All Files (*)"));
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Save Image"), "", tr("PNG Image (*.png);;JPEG Image (*.jpg);;BMP Image (*.bmp);;Binary Matrice (*" BINARY_EXTENSION ");;All Files (*)"));
     if (fileName.isEmpty()) {
         return;
     }
 
-    // Save the current displayed widget as an image
-    displayedWidget->grab().save(fileName);
+    // Save the displayed matrice in the binary format (to reopen it without parsing), or the current displayed widget as an image
+    if (fileName.endsWith(BINARY_EXTENSION)) {
+        try {
+            displayedMatrice->save(fileName.toStdString());
+        } catch (const std::exception& e) {
+            QMessageBox::warning(this, "Export Failed", e.what());
+        }
+    } else {
+        displayedWidget->grab().save(fileName);
+    }
 
     // Restore the widget after screenshot
     if (displayId >= 1 && displayId <= 99)  // Graph view
@@ -85,6 +291,14 @@ void MainWindow::on_actionExport_triggered()
 }
 
 
+void MainWindow::on_actionCancel_triggered()
+{
+    // Keep the current view, and stop the running analysis
+    discardAnalysis();
+    statusBar()->showMessage("Computation cancelled");
+}
+
+
 void MainWindow::on_actionExit_triggered()
 {
     close();
@@ -93,75 +307,148 @@ void MainWindow::on_actionExit_triggered()
 
 void MainWindow::on_actionBasicGraphView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 1;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
+    // Find the clusters of the current matrice in the background (for its layout), then update the widget
+    runAnalysis(1, "the clusters", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        return &analysis.stronglyConnectedComponents(nullptr, nullptr, hooks);
+    }, [this](const AnalysisCache::Clusters* clusters) {
         displayedMatrice = currentMatrice;
-        displayedWidget = new GraphWidget(displayedMatrice, this);
+        displayedWidget = new GraphWidget(displayedMatrice, *clusters, this);
         setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
-        setCentralWidget(displayedWidget);
-    }
+    });
 }
 
 
 void MainWindow::on_actionPrimGraphView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 2;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
-        displayedMatrice = currentMatrice->prim();
-        displayedWidget = new GraphWidget(displayedMatrice, this);
-        setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
+    // Compute the minimum spanning tree (with the fastest engine for this graph) and its clusters in the background, then update the widget
+    struct Result {
+        const Matrice* tree;
+        const AnalysisCache::Clusters* clusters;
+        Matrice::SpanningTreeEngine engine;
+    };
+    runAnalysis(2, "the minimum spanning tree", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.tree = analysis.minimumSpanningTree(&result.engine, hooks);
+        result.clusters = &analysis.stronglyConnectedComponents(result.tree, nullptr, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = result.tree;
+        displayedWidget = new GraphWidget(displayedMatrice, *result.clusters, this);
         setCentralWidget(displayedWidget);
+        showAnalysisMessage(QString("Minimum spanning tree computed with %1").arg(Matrice::spanningTreeEngineName(result.engine)));
+    });
+}
+
+
+void MainWindow::on_actionFloydWarshallGraphView_triggered()
+{
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
+        displayId = 3;
+        return;
     }
+
+    // Compute the shortest routes (with the fastest engine for this graph) and the clusters in the background,
+    // then display the current matrice, with the routes that can be highlighted
+    struct Result {
+        const Matrice* distances;
+        const Matrice* nextHops;
+        const AnalysisCache::Clusters* clusters;
+        Matrice::ShortestPathsEngine engine;
+    };
+    runAnalysis(3, "the shortest paths", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.distances = analysis.shortestPaths(&result.nextHops, &result.engine, hooks);
+        result.clusters = &analysis.stronglyConnectedComponents(nullptr, nullptr, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = currentMatrice;
+        GraphWidget* graphWidget = new GraphWidget(displayedMatrice, *result.clusters, this);
+        graphWidget->setRoutes(result.distances, result.nextHops);
+        displayedWidget = graphWidget;
+        setCentralWidget(displayedWidget);
+        showAnalysisMessage(QString("Shortest paths computed with %1").arg(Matrice::shortestPathsEngineName(result.engine)));
+    });
 }
 
 
 void MainWindow::on_actionClustersGraphView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 4;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
-        displayedMatrice = currentMatrice->clusterMatrice();
-        displayedWidget = new GraphWidget(displayedMatrice, this);
-        setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
+    // Compute the graph of the clusters (found by the fastest engine for this graph) in the background, then update the widget
+    struct Result {
+        const Matrice* clusterMatrice;
+        const AnalysisCache::Clusters* clusters;
+        Matrice::SccEngine engine;
+    };
+    runAnalysis(4, "the clusters", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.clusterMatrice = analysis.clusterMatrice(&result.engine, hooks);
+        result.clusters = &analysis.stronglyConnectedComponents(result.clusterMatrice, nullptr, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = result.clusterMatrice;
+        displayedWidget = new GraphWidget(displayedMatrice, *result.clusters, this);
         setCentralWidget(displayedWidget);
+        showAnalysisMessage(QString("Clusters found with %1").arg(Matrice::sccEngineName(result.engine)));
+    });
+}
+
+
+void MainWindow::on_actionDistancesGraphView_triggered()
+{
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
+        displayId = 5;
+        return;
     }
+
+    // Find the clusters of the current matrice in the background (for its layout), then display it, where the distances from a node
+    // can be shown (computed only for this node, when it is selected)
+    runAnalysis(5, "the clusters", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        return &analysis.stronglyConnectedComponents(nullptr, nullptr, hooks);
+    }, [this](const AnalysisCache::Clusters* clusters) {
+        displayedMatrice = currentMatrice;
+        GraphWidget* graphWidget = new GraphWidget(displayedMatrice, *clusters, this);
+        graphWidget->setSourceSelection();
+        connect(graphWidget, &GraphWidget::sourceSelected, this, [this, graphWidget](uint32_t node) {
+            showDistancesFrom(graphWidget, node);
+        });
+        displayedWidget = graphWidget;
+        setCentralWidget(displayedWidget);
+    });
 }
 
 
 void MainWindow::on_actionBasicMatriceView_triggered()
 {
     try {
-        // Set the display ID
+        // Set the display ID, and discard the running analysis (this view does not need any)
         displayId = 101;
+        discardAnalysis();
+        statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
 
         // Ignore the rest of the action if there is no matrice loaded
         if (currentMatrice == nullptr) return;
@@ -173,6 +460,7 @@ void MainWindow::on_actionBasicMatriceView_triggered()
     
     // If there is an error, display the error widget
     } catch (const std::exception& e) {
+        displayedMatrice = nullptr;
         displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
         setCentralWidget(displayedWidget);
     }
@@ -181,65 +469,80 @@ void MainWindow::on_actionBasicMatriceView_triggered()
 
 void MainWindow::on_actionPrimMatriceView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 102;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
-        displayedMatrice = currentMatrice->prim();
+    // Compute the minimum spanning tree (with the fastest engine for this graph) in the background, then update the widget
+    struct Result {
+        const Matrice* tree;
+        Matrice::SpanningTreeEngine engine;
+    };
+    runAnalysis(102, "the minimum spanning tree", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.tree = analysis.minimumSpanningTree(&result.engine, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = result.tree;
         displayedWidget = new MatriceWidget(displayedMatrice, this);
         setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
-        setCentralWidget(displayedWidget);
-    }
+        showAnalysisMessage(QString("Minimum spanning tree computed with %1").arg(Matrice::spanningTreeEngineName(result.engine)));
+    });
 }
 
 
 void MainWindow::on_actionFloydWarshallMatriceView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 103;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
-        displayedMatrice = currentMatrice->floydWarshall();
+    // Compute the shortest paths (with the fastest engine for this graph) in the background, then update the widget
+    struct Result {
+        const Matrice* distances;
+        Matrice::ShortestPathsEngine engine;
+    };
+    runAnalysis(103, "the shortest paths", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.distances = analysis.shortestPaths(nullptr, &result.engine, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = result.distances;
         displayedWidget = new MatriceWidget(displayedMatrice, this);
         setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
-        setCentralWidget(displayedWidget);
-    }
+        showAnalysisMessage(QString("Shortest paths computed with %1").arg(Matrice::shortestPathsEngineName(result.engine)));
+    });
 }
 
 
 void MainWindow::on_actionClustersMatriceView_triggered()
 {
-    try {
-        // Set the display ID
+    // Ignore the action if there is no matrice loaded (the view is displayed once one is imported)
+    statusBar()->clearMessage();  // Only the views choosing an algorithm show a message
+    if (currentMatrice == nullptr) {
         displayId = 104;
+        return;
+    }
 
-        // Ignore the rest of the action if there is no matrice loaded
-        if (currentMatrice == nullptr) return;
-
-        // Set the displayed matrice to the current one and update the widget
-        displayedMatrice = currentMatrice->clusterMatrice();
+    // Compute the graph of the clusters (found by the fastest engine for this graph) in the background, then update the widget
+    struct Result {
+        const Matrice* clusterMatrice;
+        Matrice::SccEngine engine;
+    };
+    runAnalysis(104, "the clusters", [](AnalysisCache& analysis, const ProgressHooks* hooks) {
+        Result result;
+        result.clusterMatrice = analysis.clusterMatrice(&result.engine, hooks);
+        return result;
+    }, [this](const Result& result) {
+        displayedMatrice = result.clusterMatrice;
         displayedWidget = new MatriceWidget(displayedMatrice, this);
         setCentralWidget(displayedWidget);
-    
-    // If there is an error, display the error widget
-    } catch (const std::exception& e) {
-        displayedWidget = new ErrorWidget(e.what(), "Invalid Graph", this);
-        setCentralWidget(displayedWidget);
-    }
+        showAnalysisMessage(QString("Clusters found with %1").arg(Matrice::sccEngineName(result.engine)));
+    });
 }
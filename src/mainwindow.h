@@ -1,9 +1,16 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "analysiscache.h"
 #include "matrice.h"
 
+#include <QElapsedTimer>
 #include <QMainWindow>
+#include <QProgressBar>
+#include <QThread>
+#include <QToolButton>
+
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -11,6 +18,8 @@ namespace Ui {
 }
 QT_END_NAMESPACE
 
+class GraphWidget;
+
 /**
  * @brief The MainWindow class represents the main window of the application.
  * It allows users to visualize and manipulate matrices and graphs.
@@ -43,7 +52,65 @@ private:
     const Matrice* currentMatrice;
 
     /**
-     * @brief Pointer to the matrix currently used to display the central widget
+     * @brief The results of the analyses of the current matrix, shared by all the views (invalidated when another matrix is imported).
+     * It is only used on the analysis thread (see `runAnalysis`), which also deletes the previous matrices.
+     */
+    AnalysisCache analysis;
+
+    /**
+     * @brief The thread running the analyses, one at a time and in the order they were requested
+     */
+    QThread* analysisThread;
+
+    /**
+     * @brief An object living in the analysis thread, to which the analyses are posted
+     */
+    QObject* analysisContext;
+
+    /**
+     * @brief The indicator shown in the status bar while an analysis is running (a busy indicator until its algorithm reports its progress)
+     */
+    QProgressBar* analysisProgress;
+
+    /**
+     * @brief The button shown next to the indicator, to cancel the running analysis (see the "Cancel Computation" action)
+     */
+    QToolButton* analysisCancelButton;
+
+    /**
+     * @brief The number of analyses requested (or discarded): the result of an analysis is only displayed if no other one was requested since
+     * (and no matrix imported, nor view switched, nor analysis cancelled), and an analysis discarded before it starts is skipped
+     */
+    std::atomic<uint64_t> analysisRequest{0};
+
+    /**
+     * @brief The token stopping the running analysis, raised whenever it is discarded (and lowered when the next one starts)
+     */
+    CancellationToken analysisCancellation;
+
+    /**
+     * @brief What the running analysis computes, for the status bar (ex. "the shortest paths")
+     */
+    QString analysisDescription;
+
+    /**
+     * @brief The time since the current algorithm of the running analysis started, to estimate the time left
+     */
+    QElapsedTimer analysisTimer;
+
+    /**
+     * @brief The last progress reported by the current algorithm of the running analysis (an analysis can run several ones in a row)
+     */
+    uint64_t analysisDone = 0;
+
+    /**
+     * @brief The hit and miss counters of the analysis cache, as of the last analysis displayed
+     */
+    uint64_t analysisHits = 0;
+    uint64_t analysisMisses = 0;
+
+    /**
+     * @brief Pointer to the matrix currently used to display the central widget (the current one, or a result owned by `analysis`)
      */
     const Matrice* displayedMatrice;
 
@@ -56,7 +123,9 @@ private:
      * @brief Identifier for the current display mode
      *   1: Basic Graph View
      *   2: Prim Graph View
+     *   3: Floyd-Warshall Graph View
      *   4: Clusters Graph View
+     *   5: Distances Graph View
      * 101: Basic Matrice View
      * 102: Prim Matrice View
      * 103: Floyd-Warshall Matrice View
@@ -64,6 +133,50 @@ private:
      */
     uint8_t displayId;
 
+    /**
+     * @brief Show a message in the status bar, followed by the hit and miss counters of the analysis cache
+     * @param message The message
+     */
+    void showAnalysisMessage(const QString& message);
+
+    /**
+     * @brief Compute the result of a view on the analysis thread, then display it (on this thread) once it is ready.
+     * The previous view stays displayed until then, and the result is discarded if anything else is requested in the meantime.
+     * @param view The identifier of the view (see `displayId`), set once the result is displayed
+     * @param description What is computed, for the status bar (ex. "the shortest paths")
+     * @param compute Computes the result from the analysis cache, with the hooks to give to its requests (called on the analysis thread,
+     * it may throw std::exception, including `CancelledError` once the analysis is discarded)
+     * @param display Displays the result (called on this thread)
+     */
+    template<typename Compute, typename Display>
+    void runAnalysis(uint8_t view, const QString& description, Compute compute, Display display);
+
+    /**
+     * @brief Show or hide the progress indicator and the cancel button of the analyses
+     * @param running Whether an analysis is running
+     */
+    void setAnalysisRunning(bool running);
+
+    /**
+     * @brief Show the progress of the running analysis, and an estimate of the time left, in the status bar
+     * @param done The work done by its current algorithm
+     * @param total The total work of its current algorithm
+     */
+    void showAnalysisProgress(uint64_t done, uint64_t total);
+
+    /**
+     * @brief Discard the result of the running analysis, if any, and stop it (what its algorithms already computed stays in the cache)
+     */
+    void discardAnalysis();
+
+    /**
+     * @brief Compute the shortest paths from a source on the analysis thread, then show them in the graph view of the distances
+     * (they are discarded if another file is imported or another view is displayed in the meantime)
+     * @param graphWidget The displayed graph view of the distances
+     * @param node The index of the source, or UINT32_MAX to only stop computing the previous one (the distances were cleared)
+     */
+    void showDistancesFrom(GraphWidget* graphWidget, uint32_t node);
+
 private slots:
     /**
      * @brief Slot for the "Import Matrice" action
@@ -75,6 +188,11 @@ private slots:
      */
     void on_actionExport_triggered();
 
+    /**
+     * @brief Slot for the "Cancel Computation" action
+     */
+    void on_actionCancel_triggered();
+
     /**
      * @brief Slot for the "Exit" action
      */
@@ -90,11 +208,21 @@ private slots:
      */
     void on_actionPrimGraphView_triggered();
 
+    /**
+     * @brief Slot for the "Floyd-Warshall Graph" view
+     */
+    void on_actionFloydWarshallGraphView_triggered();
+
     /**
      * @brief Slot for the "Clusters Graph" view
      */
     void on_actionClustersGraphView_triggered();
 
+    /**
+     * @brief Slot for the "Distances Graph" view
+     */
+    void on_actionDistancesGraphView_triggered();
+
     /**
      * @brief Slot for the "Basic Matrice" view
      */
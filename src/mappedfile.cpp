@@ -0,0 +1,102 @@
+#include "mappedfile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************
+| Constructors and Destructor |
+******************************/
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path):
+    data(nullptr),
+    length(0),
+    file(INVALID_HANDLE_VALUE),
+    mapping(nullptr)
+{
+    // Open the file
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        throw std::runtime_error("Could not open file");
+    }
+    length = static_cast<size_t>(fileSize.QuadPart);
+
+    // Map it (empty files cannot be mapped, and do not need to be)
+    if (length == 0) return;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Could not map file");
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path):
+    data(nullptr),
+    length(0)
+{
+    // Open the file
+    int file = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0) {
+        if (file >= 0) close(file);
+        throw std::runtime_error("Could not open file");
+    }
+    length = static_cast<size_t>(status.st_size);
+
+    // Map it (empty files cannot be mapped, and do not need to be), the mapping stays valid once the file is closed
+    if (length != 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapped == MAP_FAILED) {
+            close(file);
+            throw std::runtime_error("Could not map file");
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);  // Hint the kernel to read ahead
+        data = static_cast<const char*>(mapped);
+    }
+    close(file);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data) munmap(const_cast<char*>(data), length);
+}
+
+#endif
+
+/**********************
+| Getters and Setters |
+**********************/
+
+const char* MappedFile::getData() const
+{
+    return data;
+}
+
+size_t MappedFile::getLength() const
+{
+    return length;
+}
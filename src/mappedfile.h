@@ -0,0 +1,74 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A read-only view of a whole file, mapped in memory by the operating system.
+ * Pages are only read from the disk when accessed, and no copy of the file is made.
+ */
+class MappedFile
+{
+
+public:
+    /******************************
+    | Constructors and Destructor |
+    ******************************/
+
+    /**
+     * @brief Map a file in memory.
+     * @param path The path to the file.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    MappedFile(const std::string& path);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**********************
+    | Getters and Setters |
+    **********************/
+
+    /**
+     * @brief Get the first byte of the file (nullptr if the file is empty).
+     * @return The content of the file.
+     */
+    const char* getData() const;
+
+    /**
+     * @brief Get the size of the file.
+     * @return The size of the file, in bytes.
+     */
+    size_t getLength() const;
+
+private:
+    /*************
+    | Attributes |
+    *************/
+
+    /**
+     * @brief The first byte of the mapping (nullptr if the file is empty).
+     */
+    const char* data;
+
+    /**
+     * @brief The size of the file, in bytes.
+     */
+    size_t length;
+
+#ifdef _WIN32
+    /**
+     * @brief The handles of the file and of its mapping.
+     */
+    void* file;
+    void* mapping;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -1,7 +1,71 @@
 #include "matrice.h"
 
+#include "binaryformat.h"
+#include "daryheap.h"
+#include "hardware.h"
+#include "mappedfile.h"
+#include "matriceparser.h"
+#include "minplus.h"
+#include "primkernels.h"
+#include "radixheap.h"
+#include "threadpool.h"
+#include "unionfind.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <limits>
+#include <new>
+#include <ostream>
 #include <stdexcept>
+#include <type_traits>
+
+/***************
+| Cells Access |
+***************/
+
+// Defined first, as its return type is deduced (it must be known before any use)
+template<typename Function>
+auto Matrice::visitCells(Function&& function) const
+{
+    if (layout == Layout::Bits) {
+        return function(BitCells{static_cast<uint64_t*>(data), stride, size});
+    }
+    return dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        if (layout == Layout::Sparse) {
+            return function(SparseCells<T>{sparse.offsets, sparse.columns, static_cast<T*>(sparse.weights), size});
+        }
+        return function(DenseCells<T>{static_cast<T*>(data), stride, size});
+    });
+}
+
+template<typename Function>
+auto Matrice::visitCellsAndTranspose(Function&& function) const
+{
+    transpose();
+    if (layout == Layout::Bits) {
+        return function(BitCells{static_cast<uint64_t*>(data), stride, size}, BitCells{static_cast<uint64_t*>(transposedData), stride, size});
+    }
+    return dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        if (layout == Layout::Sparse) {
+            return function(SparseCells<T>{sparse.offsets, sparse.columns, static_cast<T*>(sparse.weights), size},
+                            SparseCells<T>{reverse.offsets, reverse.columns, static_cast<T*>(reverse.weights), size});
+        }
+        return function(DenseCells<T>{static_cast<T*>(data), stride, size}, DenseCells<T>{static_cast<T*>(transposedData), stride, size});
+    });
+}
+
+template<typename Function>
+auto Matrice::visitReverseCells(Function&& function) const
+{
+    return visitCellsAndTranspose([&](auto, auto reverseCells) { return function(reverseCells); });
+}
 
 /******************************
 | Constructors and Destructor |
@@ -11,50 +75,58 @@ Matrice::Matrice(uint32_t size, int32_t** data, std::string* names):
     size(size),
     names(names)
 {
-    // Convert and copy the data to int64_t
-    this->data = new int64_t*[size];
+    // Find the range of the values and count the edges, to store them in the most compact way
+    int32_t min = 0, max = 0;
+    uint64_t nonZero = 0;
     for (uint32_t i = 0; i < size; i++) {
-        this->data[i] = new int64_t[size];
         for (uint32_t j = 0; j < size; j++) {
-            this->data[i][j] = data[i][j];
+            min = std::min(min, data[i][j]);
+            max = std::max(max, data[i][j]);
+            nonZero += data[i][j] != 0;
         }
     }
+
+    // Convert and copy the data
+    storeCompact([&](uint32_t i) { return data[i]; }, min, max, nonZero);
 }
 
 Matrice::Matrice(const std::string& path):
+    data(nullptr),
     names(nullptr)
 {
-    // Open the file
-    std::ifstream file(path);
-    if (!file) {
-        throw std::runtime_error("Could not open file");
-    }
-
-    // Read the size of the matrix (first line of the file)
-    file >> size;
-    data = new int64_t*[size];  // Avoids inserting int64_t here, as it could lead to issues later on
-
-    // Read the matrix data
-    int32_t value;
-    for (uint32_t i = 0; i < size; i++) {
-        data[i] = new int64_t[size];
-        for (uint32_t j = 0; j < size; j++) {
-            file >> value;
-            data[i][j] = value;
+    // Map the file in memory
+    MappedFile* file = new MappedFile(path);
+    try {
+        // Binary files are used in place, so the mapping is kept as long as the matrix
+        if (file->getLength() >= sizeof(BinaryHeader) && std::memcmp(file->getData(), BINARY_MAGIC, sizeof(BinaryHeader::magic)) == 0) {
+            openBinary(*file);
+            mapping = file;
+            return;
         }
-    }
 
-    // Free the resources
-    file.close();
+        // Text files are parsed and converted, so the mapping is only needed while parsing
+        parseText(*file);
+    } catch (...) {
+        delete file;
+        throw;
+    }
+    delete file;
 }
 
 Matrice::~Matrice()
 {
-    // Free the data
-    for (uint32_t i = 0; i < size; i++) {
-        delete[] data[i];
+    // Free the data (unless it is stored in a mapped file)
+    if (mapping) {
+        delete mapping;
+    } else {
+        deallocate(data);
+        for (SparseRows* rows : {&sparse, &reverse}) {
+            deallocate(rows->offsets);
+            deallocate(rows->columns);
+            deallocate(rows->weights);
+        }
     }
-    delete[] data;
+    deallocate(transposedData);
 
     // Free the names
     if (names) {
@@ -70,9 +142,9 @@ Matrice::operator std::string() const
 {
     std::string result;
     for (uint32_t i = 0; i < size; ++i) {
-        result += std::to_string(data[i][0]);
+        result += std::to_string(getEdge(i, 0));
         for (uint32_t j = 1; j < size; ++j) {
-            result += " " + std::to_string(data[i][j]);
+            result += " " + std::to_string(getEdge(i, j));
         }
         result += "\n";
     }
@@ -85,6 +157,79 @@ std::ostream& operator<<(std::ostream& os, const Matrice& m)
     return os;
 }
 
+/*********
+| Export |
+*********/
+
+void Matrice::save(const std::string& path) const
+{
+    // Open a temporary file, renamed once complete (the previous file may still be mapped by a matrix, and must not be truncated)
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open file");
+    }
+
+    // Find the buffers to write, in the order of the sections
+    uint64_t cells = layout == Layout::Sparse ? sparse.offsets[size] : 0;
+    std::vector<size_t> sections = binarySections(size, layout, type, cells);
+    std::vector<const void*> buffers;
+    if (layout == Layout::Sparse) {
+        buffers = {sparse.offsets, sparse.columns, sparse.weights, reverse.offsets, reverse.columns, reverse.weights};
+    } else {
+        buffers = {data};
+    }
+
+    // Fill the header, with each section starting on a cache line
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.size = size;
+    header.stride = layout == Layout::Sparse ? 0 : stride;
+    header.layout = static_cast<uint8_t>(layout);
+    header.type = static_cast<uint8_t>(type);
+    header.oriented = isOriented();
+    header.weighted = isWeighted();
+    header.cells = cells;
+    header.dataOffset = sizeof(BinaryHeader);
+    uint64_t length = header.dataOffset;
+    for (size_t bytes : sections) {
+        length = (length + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE + bytes;
+    }
+    if (names) {
+        header.namesOffset = length;
+        for (uint32_t i = 0; i < size; i++) {
+            length += sizeof(uint32_t) + names[i].size();
+        }
+    }
+    header.length = length;
+
+    // Write the header, the sections (padded with zeros) and the names
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t position = sizeof(header);
+    const char padding[CACHE_LINE_SIZE] = {};
+    for (size_t k = 0; k < sections.size(); k++) {
+        file.write(padding, (CACHE_LINE_SIZE - position % CACHE_LINE_SIZE) % CACHE_LINE_SIZE);
+        file.write(static_cast<const char*>(buffers[k]), sections[k]);
+        position = (position + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE + sections[k];
+    }
+    if (names) {
+        for (uint32_t i = 0; i < size; i++) {
+            uint32_t nameLength = names[i].size();
+            file.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+            file.write(names[i].data(), nameLength);
+        }
+    }
+
+    // Check that everything was written, and replace the previous file
+    file.close();
+    if (!file) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Could not write file");
+    }
+    std::filesystem::rename(temporaryPath, path);
+}
+
 /**********************
 | Getters and Setters |
 **********************/
@@ -96,7 +241,9 @@ uint32_t Matrice::getSize() const
 
 int64_t Matrice::getEdge(uint32_t from, uint32_t to) const
 {
-    return data[from][to];
+    return visitCells([&](auto cells) -> int64_t {
+        return cells.get(from, to);  // Infinity (the maximum of each type) is returned as INT64_MAX
+    });
 }
 
 std::string Matrice::getName(uint32_t index) const
@@ -108,23 +255,87 @@ std::string Matrice::getName(uint32_t index) const
     }
 }
 
+CellType Matrice::getCellType() const
+{
+    return type;
+}
+
+Matrice::Layout Matrice::getLayout() const
+{
+    return layout;
+}
+
 bool Matrice::isOriented() const
 {
     // Check if the computation has already been done
     if (oriented == 0) return false;
     else if (oriented == 1) return true;
 
-    // Check for any pair (i, j) such that edge[i][j] != edge[j][i]
-    for (uint32_t i = 0; i < size; i++) {
-        for (uint32_t j = i + 1; j < size; j++) {  // j starts at i+1 to avoid checking twice and self-loops
-            if (data[i][j] != data[j][i]) {
-                oriented = 1;  // Mark as oriented
-                return true;
+    // For bit matrices, compare each 64x64 block with the transposition of its mirror block, word by word
+    if (layout == Layout::Bits) {
+        BitCells cells{static_cast<uint64_t*>(data), stride, size};
+        uint32_t blocks = (size + 63) / 64;
+        uint64_t block[64];
+        for (uint32_t blockI = 0; blockI < blocks; blockI++) {
+            for (uint32_t blockJ = blockI; blockJ < blocks; blockJ++) {
+                // Transpose the block (blockJ, blockI), then compare it with the block (blockI, blockJ)
+                for (uint32_t k = 0; k < 64; k++) {
+                    uint32_t i = blockJ * 64 + k;
+                    block[k] = i < size ? cells.row(i)[blockI] : 0;
+                }
+                transposeBitBlock(block);
+                for (uint32_t k = 0; k < 64 && blockI * 64 + k < size; k++) {
+                    if (cells.row(blockI * 64 + k)[blockJ] != block[k]) {
+                        oriented = 1;  // Mark as oriented
+                        return true;
+                    }
+                }
             }
         }
+        oriented = 0;  // Mark as not oriented
+        return false;
     }
-    oriented = 0;  // Mark as not oriented
-    return false;
+
+    // For sparse matrices, the graph is not oriented if and only if the rows are the same as the transposed rows
+    if (layout == Layout::Sparse) {
+        uint64_t edges = sparse.offsets[size];
+        bool symmetric = std::equal(sparse.offsets, sparse.offsets + size + 1, reverse.offsets)
+                      && std::equal(sparse.columns, sparse.columns + edges, reverse.columns)
+                      && std::memcmp(sparse.weights, reverse.weights, edges * cellSize(type)) == 0;
+        oriented = symmetric ? 0 : 1;
+        return !symmetric;
+    }
+
+    // Check for any pair (i, j) such that edge[i][j] != edge[j][i], by 64x64 blocks: the columns of the mirror block
+    // are then read from a few cache lines, instead of a new cache line for each cell
+    oriented = visitCells([&](auto cells) -> uint8_t {
+        for (uint32_t blockI = 0; blockI < size; blockI += 64) {
+            for (uint32_t blockJ = blockI; blockJ < size; blockJ += 64) {
+                for (uint32_t i = blockI; i < std::min(size, blockI + 64); i++) {
+                    for (uint32_t j = std::max(blockJ, i + 1); j < std::min(size, blockJ + 64); j++) {  // j > i, to avoid checking twice and self-loops
+                        if (cells.get(i, j) != cells.get(j, i)) {
+                            return 1;  // Mark as oriented
+                        }
+                    }
+                }
+            }
+        }
+        return 0;  // Mark as not oriented
+    });
+    return oriented == 1;
+}
+
+int64_t Matrice::getTotalWeight() const
+{
+    return visitCells([&](auto cells) {
+        int64_t total = 0;
+        for (uint32_t i = 0; i < size; i++) {
+            cells.forEachInRow(i, [&](uint32_t, int64_t weight) {
+                if (weight != INT64_MAX) total += weight;
+            });
+        }
+        return total;
+    });
 }
 
 bool Matrice::isWeighted() const
@@ -133,64 +344,479 @@ bool Matrice::isWeighted() const
     if (weighted == 0) return false;
     else if (weighted == 1) return true;
 
+    // Bit matrices only contain 0 and 1
+    if (layout == Layout::Bits) {
+        weighted = 0;
+        return false;
+    }
+
     // Check for any edge with a weight different from 0 or 1
-    for (uint32_t i = 0; i < size; i++) {
-        for (uint32_t j = 0; j < size; j++) {
-            if (data[i][j] != 0 && data[i][j] != 1) {
-                weighted = 1;  // Mark as weighted
-                return true;
-            }
+    weighted = visitCells([&](auto cells) -> uint8_t {
+        for (uint32_t i = 0; i < size; i++) {
+            bool found = false;
+            cells.forEachInRow(i, [&](uint32_t, int64_t value) {
+                found |= value != 1;
+            });
+            if (found) return 1;  // Mark as weighted
         }
-    }
-    weighted = 0;  // Mark as not weighted
-    return false;
+        return 0;  // Mark as not weighted
+    });
+    return weighted == 1;
 }
 
 /*************
 | Algorithms |
 *************/
 
-Matrice* Matrice::floydWarshall() const
-{   
-    // Create a new matrix to store the path lengths
-    int64_t** paths = new int64_t*[size];
-    for (uint32_t i = 0; i < size; i++) {
-        paths[i] = new int64_t[size];
-        for (uint32_t j = 0; j < size; j++) {
-            // Initialize paths with the current edge weights, using INT64_MAX for no edge (infinite length)
-            paths[i][j] = data[i][j] == 0 ? INT64_MAX : data[i][j];
+Matrice* Matrice::floydWarshall(uint32_t tileSize, uint32_t threads, Matrice** nextHops, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return floydWarshall(tileSize, threads, nextHops, progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::floydWarshall(uint32_t tileSize, uint32_t threads, Matrice** nextHops, Progress& progress) const
+{
+    // Choose the narrowest type able to store the sum of two paths, from the range of the weights
+    int64_t minWeight, maxWeight;
+    weightRange(&minWeight, &maxWeight);
+    CellType pathsType = shortestPathsType(minWeight, maxWeight);
+
+    // Use the shared thread pool, or a dedicated one for the requested number of threads
+    ThreadPool* ownPool = threads != 0 ? new ThreadPool(threads) : nullptr;
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+
+    // Create a new matrix to store the path lengths, and another one for the next hops if requested
+    // (node indexes, stored in the narrowest type able to hold them)
+    void* paths = allocate(size, pathsType);
+    uint32_t pathsStride = computeStride(size, pathsType);
+    CellType hopsType = fittingCellType(0, size);
+    void* hops = nextHops != nullptr ? allocate(size, hopsType) : nullptr;
+    uint32_t hopsStride = computeStride(size, hopsType);
+    dispatchCellType(pathsType, [&](auto pathsTag) {
+        using P = decltype(pathsTag);
+        const P infinity = std::numeric_limits<P>::max();
+
+        // Initialize paths with the current edge weights, using the maximum value for no edge (infinite length)
+        // The padding of the rows is infinite as well, so that rows can be relaxed by whole cache lines
+        visitCells([&](auto cells) {
+            for (uint32_t i = 0; i < size; i++) {
+                P* pathsRow = static_cast<P*>(paths) + static_cast<size_t>(i) * pathsStride;
+                std::fill(pathsRow, pathsRow + pathsStride, infinity);
+                cells.forEachInRow(i, [&](uint32_t j, int64_t weight) {
+                    if (weight != INT64_MAX) pathsRow[j] = static_cast<P>(weight);
+                });
+            }
+        });
+
+        // Choose the tile size, in whole cache lines. With several threads, the automatic size is reduced until there are
+        // enough tiles per block of intermediate nodes to keep every thread busy
+        P* pathsData = static_cast<P*>(paths);
+        const uint32_t cellsPerLine = CACHE_LINE_SIZE / sizeof(P);
+        const uint32_t threadCount = pool.getThreadCount();
+        uint32_t tile = tileSize != 0 ? (tileSize + cellsPerLine - 1) / cellsPerLine * cellsPerLine : floydWarshallTileSize(pathsType);
+        while (tileSize == 0 && threadCount > 1 && tile > cellsPerLine) {
+            uint64_t otherBlocks = (size + tile - 1) / tile - 1;
+            if (otherBlocks * otherBlocks >= 4 * static_cast<uint64_t>(threadCount)) break;
+            tile = std::max(cellsPerLine, tile / 2 / cellsPerLine * cellsPerLine);
         }
+
+        // Compute the shortest paths tile by tile: for each block of intermediate nodes, first relax the diagonal tile
+        // (paths between these nodes), then the tiles of their rows and columns (which only depend on the diagonal tile),
+        // and finally the other tiles (which only depend on a tile of the row and a tile of the column).
+        // The tiles of each of the last two steps are independent, so they are spread over the threads
+        // (each tile is computed exactly as by a single thread, so the result does not depend on the number of threads)
+        uint32_t blocks = (size + tile - 1) / tile;
+        auto rowsEnd = [&](uint32_t block) { return std::min(size, (block + 1) * tile); };
+        auto columnsEnd = [&](uint32_t block) { return std::min(pathsStride, (block + 1) * tile); };  // Columns go up to the end of the padding
+        auto computeTiles = [&](auto relax) {
+            for (uint32_t kBlock = 0; kBlock < blocks; kBlock++) {
+                uint32_t kBegin = kBlock * tile;
+                uint32_t kEnd = rowsEnd(kBlock);
+                if (!progress.report(kBegin)) return;  // Cancelled: the paths are freed below
+                floydWarshallTile(pathsData, pathsStride, kBegin, kEnd, kBegin, kEnd, kBegin, columnsEnd(kBlock), relax);
+                pool.parallelFor(2 * (blocks - 1), [&](uint64_t index) {
+                    uint32_t block = index / 2;
+                    block += block >= kBlock;  // Skip the diagonal tile
+                    if (index % 2 == 0) {
+                        floydWarshallTile(pathsData, pathsStride, kBegin, kEnd, kBegin, kEnd, block * tile, columnsEnd(block), relax);
+                    } else {
+                        floydWarshallTile(pathsData, pathsStride, kBegin, kEnd, block * tile, rowsEnd(block), kBegin, columnsEnd(kBlock), relax);
+                    }
+                });
+                pool.parallelFor(static_cast<uint64_t>(blocks - 1) * (blocks - 1), [&](uint64_t index) {
+                    uint32_t iBlock = index / (blocks - 1);
+                    uint32_t jBlock = index % (blocks - 1);
+                    iBlock += iBlock >= kBlock;  // Skip the row and the column of the diagonal tile
+                    jBlock += jBlock >= kBlock;
+                    floydWarshallTile(pathsData, pathsStride, kBegin, kEnd, iBlock * tile, rowsEnd(iBlock), jBlock * tile, columnsEnd(jBlock), relax);
+                });
+            }
+            progress.report(size);
+        };
+
+        // The rows of the tiles are relaxed by the newest SIMD kernel supported by the processor, chosen once
+        if (hops == nullptr) {
+            const MinPlusKernel<P> kernel = minPlusKernel<P>();
+            computeTiles([&](uint32_t, uint32_t, P* rowI, const P* rowK, P pathIK, uint32_t jBegin, uint32_t jEnd) {
+                kernel(rowI + jBegin, rowK + jBegin, pathIK, jEnd - jBegin);
+            });
+            return;
+        }
+
+        // With the next hops, the next hop of `i -> j` becomes the one of `i -> k` whenever the path through `k` is shorter.
+        // Both are read at the same time as the length of `i -> k`, so each path always starts with its next hop, whatever the order of the tiles
+        dispatchCellType(hopsType, [&](auto hopsTag) {
+            using H = decltype(hopsTag);
+            H* hopsData = static_cast<H*>(hops);
+            for (uint32_t i = 0; i < size; i++) {
+                H* hopsRow = hopsData + static_cast<size_t>(i) * hopsStride;
+                const P* pathsRow = pathsData + static_cast<size_t>(i) * pathsStride;
+                for (uint32_t j = 0; j < hopsStride; j++) {
+                    hopsRow[j] = j < size && pathsRow[j] != infinity ? static_cast<H>(j) : std::numeric_limits<H>::max();
+                }
+            }
+
+            const MinPlusHopsKernel<P, H> kernel = minPlusHopsKernel<P, H>();
+            computeTiles([&](uint32_t i, uint32_t k, P* rowI, const P* rowK, P pathIK, uint32_t jBegin, uint32_t jEnd) {
+                H* hopsI = hopsData + static_cast<size_t>(i) * hopsStride;
+                jEnd = std::min(jEnd, size);  // The rows of next hops are not padded like the rows of paths
+                kernel(rowI + jBegin, rowK + jBegin, pathIK, hopsI + jBegin, hopsI[k], jEnd - jBegin);
+            });
+        });
+    });
+    delete ownPool;
+
+    if (progress.stopped()) {
+        deallocate(paths);
+        deallocate(hops);
+        throw CancelledError();
     }
 
-    // Compute the shortest paths
-    for (uint32_t k = 0; k < size; k++) {
-        for (uint32_t i = 0; i < size; i++) {
-            if (i == k) continue;  // Skip self-loops
-            for (uint32_t j = 0; j < size; j++) {
-                if (j == k) continue;  // Skip self-loops
-                if (paths[i][k] == INT64_MAX || paths[k][j] == INT64_MAX) continue;  // Skip "infinite" lengths
+    if (nextHops != nullptr) {
+        *nextHops = new Matrice(size, Layout::Dense, hopsType, hops);
+    }
+    return new Matrice(size, Layout::Dense, pathsType, paths);  // Uses the private constructor (faster)
+}
+
+std::vector<uint32_t> Matrice::route(uint32_t from, uint32_t to) const
+{
+    // No path at all
+    if (getEdge(from, to) == INT64_MAX) return {};
+
+    // Follow the next hops until the destination (a path has at most `size` edges, unless there is a negative cycle)
+    std::vector<uint32_t> nodes{from};
+    uint32_t node = from;
+    do {
+        int64_t hop = getEdge(node, to);
+        if (hop == INT64_MAX || nodes.size() > size) {
+            throw std::runtime_error("The path goes through a negative cycle, so it has no shortest route.");
+        }
+        node = static_cast<uint32_t>(hop);
+        nodes.push_back(node);
+    } while (node != to);
+    return nodes;
+}
+
+Matrice* Matrice::johnson(uint32_t threads, Matrice** nextHops, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return johnson(threads, nextHops, progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::johnson(uint32_t threads, Matrice** nextHops, Progress& progress) const
+{
+    // Choose the same cell type as Floyd-Warshall, from the range of the weights
+    int64_t minWeight, maxWeight;
+    weightRange(&minWeight, &maxWeight);
+    CellType pathsType = shortestPathsType(minWeight, maxWeight);
+    Adjacency graph = adjacency();
 
-                // Update the path if a shorter one is found
-                int64_t length = paths[i][k] + paths[k][j];
-                if (length < paths[i][j]) {
-                    paths[i][j] = length;
+    // With negative weights, find the potential of each node with Bellman-Ford, from a virtual node linked to every node by a 0-weight edge.
+    // Adding `potential[from] - potential[to]` to each edge makes every weight non-negative, and adds the same value to every path between
+    // two given nodes, so the shortest paths are kept. With n+1 nodes, a path still shorter after n passes goes through a negative cycle
+    std::vector<int64_t> potentials(size, 0);
+    if (minWeight < 0) {
+        for (uint32_t pass = 0; ; pass++) {
+            bool changed = false;
+            for (uint32_t from = 0; from < size; from++) {
+                for (uint64_t edge = graph.offsets[from]; edge < graph.offsets[from + 1]; edge++) {
+                    int64_t potential = potentials[from] + graph.weights[edge];
+                    if (potential < potentials[graph.targets[edge]]) {
+                        potentials[graph.targets[edge]] = potential;
+                        changed = true;
+                    }
                 }
             }
+            if (!changed) break;
+            if (pass == size) {
+                throw std::runtime_error("The graph contains a negative cycle, so it has no shortest paths.");
+            }
+        }
+        for (uint32_t from = 0; from < size; from++) {
+            for (uint64_t edge = graph.offsets[from]; edge < graph.offsets[from + 1]; edge++) {
+                graph.weights[edge] += potentials[from] - potentials[graph.targets[edge]];
+            }
         }
     }
 
-    return new Matrice(size, paths);  // Uses the private constructor (faster)
+    // Use the shared thread pool, or a dedicated one for the requested number of threads
+    ThreadPool* ownPool = threads != 0 ? new ThreadPool(threads) : nullptr;
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+
+    // Create a new matrix to store the path lengths, and another one for the next hops if requested
+    void* paths = allocate(size, pathsType);
+    uint32_t pathsStride = computeStride(size, pathsType);
+    CellType hopsType = fittingCellType(0, size);
+    void* hops = nextHops != nullptr ? allocate(size, hopsType) : nullptr;
+    uint32_t hopsStride = computeStride(size, hopsType);
+
+    // Run Dijkstra's algorithm from a node (each one only writes its own rows)
+    auto dijkstraFrom = [&](uint32_t source) {
+        std::vector<int64_t> distances(size, INT64_MAX);
+        std::vector<uint32_t> firstHops(size, UINT32_MAX);
+        DaryHeap<int64_t> heap(size);
+
+        // The source is not a path of itself: like Floyd-Warshall, its cell is the shortest cycle through it, found when relaxing its incoming edges
+        int64_t cycle = INT64_MAX;
+        uint32_t cycleHop = UINT32_MAX;
+        distances[source] = 0;
+        heap.push(source, 0);
+        while (!heap.empty()) {
+            uint32_t node = heap.pop();
+            for (uint64_t edge = graph.offsets[node]; edge < graph.offsets[node + 1]; edge++) {
+                uint32_t target = graph.targets[edge];
+                int64_t length = distances[node] + graph.weights[edge];
+                uint32_t hop = node == source ? target : firstHops[node];
+                if (target == source) {
+                    if (length < cycle) {
+                        cycle = length;
+                        cycleHop = hop;
+                    }
+                } else if (length < distances[target]) {
+                    distances[target] = length;
+                    firstHops[target] = hop;
+                    heap.push(target, length);
+                }
+            }
+        }
+        distances[source] = cycle;
+        firstHops[source] = cycleHop;
+
+        // Store the lengths with the original weights (removing the potentials), and the next hops
+        dispatchCellType(pathsType, [&](auto pathsTag) {
+            using P = decltype(pathsTag);
+            P* row = static_cast<P*>(paths) + static_cast<size_t>(source) * pathsStride;
+            std::fill(row, row + pathsStride, std::numeric_limits<P>::max());  // The padding is infinite, as with Floyd-Warshall
+            for (uint32_t node = 0; node < size; node++) {
+                if (distances[node] == INT64_MAX) continue;
+                row[node] = static_cast<P>(distances[node] - potentials[source] + potentials[node]);
+            }
+        });
+        if (hops != nullptr) {
+            dispatchCellType(hopsType, [&](auto hopsTag) {
+                using H = decltype(hopsTag);
+                H* row = static_cast<H*>(hops) + static_cast<size_t>(source) * hopsStride;
+                std::fill(row, row + hopsStride, std::numeric_limits<H>::max());
+                for (uint32_t node = 0; node < size; node++) {
+                    if (firstHops[node] != UINT32_MAX) row[node] = static_cast<H>(firstHops[node]);
+                }
+            });
+        }
+    };
+
+    // Run it from each node, in parallel. With hooks, the nodes are run by batches, the progress being reported between two batches
+    const uint32_t batch = std::is_same_v<Progress, NoProgress> ? std::max(size, 1u) : std::max(size / PROGRESS_STEPS, 16 * pool.getThreadCount());
+    for (uint32_t first = 0; first < size && progress.report(first); first += batch) {
+        pool.parallelFor(std::min(batch, size - first), [&](uint64_t index) { dijkstraFrom(first + static_cast<uint32_t>(index)); });
+    }
+    delete ownPool;
+
+    if (progress.stopped()) {
+        deallocate(paths);
+        deallocate(hops);
+        throw CancelledError();
+    }
+    progress.report(size);
+
+    if (nextHops != nullptr) {
+        *nextHops = new Matrice(size, Layout::Dense, hopsType, hops);
+    }
+    return new Matrice(size, Layout::Dense, pathsType, paths);  // Uses the private constructor (faster)
 }
 
-Matrice* Matrice::prim() const
+Matrice::ShortestPathsEngine Matrice::shortestPathsEngine() const
 {
-    // Create a new matrix to store the MST
-    int64_t** mstData = new int64_t*[size];
-    for (uint32_t i = 0; i < size; i++) {
-        mstData[i] = new int64_t[size];
-        for (uint32_t j = 0; j < size; j++) {
-            mstData[i][j] = 0;  // Initialize empty
+    // Compare the estimated costs, per source node (in relaxed Floyd-Warshall cells)
+    int64_t minWeight, maxWeight;
+    uint64_t edges;
+    weightRange(&minWeight, &maxWeight, &edges);
+    double edgeCost = minWeight < 0 ? 2.0 * JOHNSON_EDGE_COST : JOHNSON_EDGE_COST;
+    double johnsonCost = static_cast<double>(JOHNSON_NODE_COST) * size + edgeCost * static_cast<double>(edges);
+    double floydWarshallCost = static_cast<double>(size) * size;
+    return johnsonCost < floydWarshallCost ? ShortestPathsEngine::Johnson : ShortestPathsEngine::FloydWarshall;
+}
+
+Matrice* Matrice::shortestPaths(Matrice** nextHops, ShortestPathsEngine* engine, const ProgressHooks* hooks) const
+{
+    ShortestPathsEngine chosen = shortestPathsEngine();
+    if (chosen == ShortestPathsEngine::Johnson) {
+        try {
+            Matrice* paths = johnson(0, nextHops, hooks);
+            if (engine != nullptr) *engine = chosen;
+            return paths;
+        } catch (const CancelledError&) {
+            throw;
+        } catch (const std::runtime_error&) {
+            // Negative cycle: fall back to Floyd-Warshall, which does not detect them
+        }
+    }
+    if (engine != nullptr) *engine = ShortestPathsEngine::FloydWarshall;
+    return floydWarshall(0, 0, nextHops, hooks);
+}
+
+const char* Matrice::shortestPathsEngineName(ShortestPathsEngine engine)
+{
+    switch (engine) {
+        case ShortestPathsEngine::Johnson: return "Johnson";
+        default:                           return "Floyd-Warshall";
+    }
+}
+
+Matrice::SingleSourcePaths Matrice::dijkstra(uint32_t source, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return dijkstra(source, progress); });
+}
+
+template<typename Progress>
+Matrice::SingleSourcePaths Matrice::dijkstra(uint32_t source, Progress& progress) const
+{
+    SingleSourcePaths paths{std::vector<int64_t>(size, INT64_MAX), std::vector<uint32_t>(size, UINT32_MAX)};
+    std::vector<bool> settled(size, false);
+    paths.distances[source] = 0;
+
+    // Settle the nodes by increasing distance: as the weights are non-negative, the popped keys never decrease, as the radix heap requires
+    uint32_t settledCount = 0;
+    visitCells([&](auto cells) {
+        RadixHeap<uint32_t> heap;
+        heap.push(0, source);
+        while (!heap.empty()) {
+            uint32_t node = heap.pop().value;
+            if (settled[node]) continue;  // Outdated item (the node was pushed again with a smaller distance)
+            settled[node] = true;
+            if (!progress.report(settledCount++)) throw CancelledError();
+
+            int64_t distance = paths.distances[node];
+            cells.forEachInRow(node, [&](uint32_t target, int64_t weight) {
+                if (weight == INT64_MAX) return;  // Infinite weights are not edges
+                if (weight < 0) throw std::runtime_error("The graph contains negative weights, Dijkstra's algorithm cannot be applied.");
+                int64_t length = distance + weight;
+                if (length < paths.distances[target]) {
+                    paths.distances[target] = length;
+                    paths.parents[target] = node;
+                    heap.push(static_cast<uint64_t>(length), target);
+                }
+            });
+        }
+    });
+    progress.report(size);
+    return paths;
+}
+
+Matrice::SingleSourcePaths Matrice::bellmanFord(uint32_t source, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return bellmanFord(source, progress); });
+}
+
+template<typename Progress>
+Matrice::SingleSourcePaths Matrice::bellmanFord(uint32_t source, Progress& progress) const
+{
+    SingleSourcePaths paths{std::vector<int64_t>(size, INT64_MAX), std::vector<uint32_t>(size, UINT32_MAX)};
+    std::vector<uint32_t> edgeCounts(size, 0);  // Number of edges of the shortest path found for each node
+    paths.distances[source] = 0;
+
+    // Relax the edges of the nodes whose distance changed, in FIFO order (a node is at most once in the queue, so it never holds more than `size` nodes)
+    std::vector<uint32_t> queue(size);
+    std::vector<bool> queued(size, false);
+    uint32_t head = 0, count = 0;
+    queue[0] = source;
+    queued[source] = true;
+    count = 1;
+    uint32_t cycleNode = UINT32_MAX;
+    uint32_t reached = 1;  // Number of nodes with a finite distance, reported as the progress (a node can be taken from the queue many times)
+    visitCells([&](auto cells) {
+        while (count > 0 && cycleNode == UINT32_MAX) {
+            if (!progress.report(reached)) throw CancelledError();
+            uint32_t node = queue[head];
+            head = head + 1 == size ? 0 : head + 1;
+            count--;
+            queued[node] = false;
+
+            int64_t distance = paths.distances[node];
+            cells.forEachInRow(node, [&](uint32_t target, int64_t weight) {
+                if (weight == INT64_MAX || cycleNode != UINT32_MAX) return;  // Infinite weights are not edges
+                int64_t length = distance + weight;
+                if (length >= paths.distances[target]) return;
+                reached += paths.distances[target] == INT64_MAX;
+                paths.distances[target] = length;
+                paths.parents[target] = node;
+                edgeCounts[target] = edgeCounts[node] + 1;
+
+                // A shortest path has less than `size` edges: a longer one goes through a negative cycle
+                if (edgeCounts[target] >= size) {
+                    cycleNode = target;
+                    return;
+                }
+                if (!queued[target]) {
+                    queue[(head + count) % size] = target;
+                    queued[target] = true;
+                    count++;
+                }
+            });
+        }
+    });
+    if (cycleNode == UINT32_MAX) {
+        progress.report(size);
+        return paths;
+    }
+
+    // Find the cycle: going back `size` parents from the node lands on it, unless a parent was replaced meanwhile
+    std::string message = "The graph contains a negative cycle reachable from " + getName(source);
+    for (uint32_t i = 0; i < size && cycleNode != UINT32_MAX; i++) cycleNode = paths.parents[cycleNode];
+    if (cycleNode != UINT32_MAX) {
+        std::vector<uint32_t> cycle{cycleNode};
+        for (uint32_t node = paths.parents[cycleNode]; node != cycleNode && node != UINT32_MAX && cycle.size() <= size; node = paths.parents[node]) {
+            cycle.push_back(node);
         }
+        // The parents go backward: the cycle goes from the node to the last parent found, and back to the node through the others
+        message += " (" + getName(cycleNode);
+        for (auto node = cycle.rbegin(); node != cycle.rend(); node++) message += " >> " + getName(*node);
+        message += ")";
+    }
+    throw std::runtime_error(message + ", so it has no shortest paths.");
+}
+
+Matrice::SingleSourcePaths Matrice::shortestPathsFrom(uint32_t source, const ProgressHooks* hooks) const
+{
+    try {
+        return dijkstra(source, hooks);
+    } catch (const CancelledError&) {
+        throw;
+    } catch (const std::runtime_error&) {
+        // A negative weight is reachable from the source: Bellman-Ford handles it (and reports the negative cycles)
+        return bellmanFord(source, hooks);
+    }
+}
+
+Matrice* Matrice::prim(SimdLevel level, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return prim(level, progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::prim(SimdLevel level, Progress& progress) const
+{
+    if (layout == Layout::Dense) {
+        return dispatchCellType(type, [&](auto tag) { return densePrim<decltype(tag)>(level, progress); });
     }
 
     // Array to track vertex data
@@ -203,10 +829,10 @@ Matrice* Matrice::prim() const
         parent[i] = UINT32_MAX;
     }
 
-    // Start from the first vertex
-    distance[0] = 0;
-
-    for (uint32_t _ = 0; _ < size - 1; _++) {  // There will be n-1 edges
+    std::vector<Edge> edges;
+    edges.reserve(2 * static_cast<size_t>(size));
+    uint32_t nextRoot = 0;
+    for (uint32_t _ = 0; _ < size && progress.report(_); _++) {  // Each iteration adds a vertex to the MST (unless cancelled)
         int64_t minEdge = INT64_MAX;
         uint32_t to = UINT32_MAX;
 
@@ -218,194 +844,1279 @@ Matrice* Matrice::prim() const
             }
         }
 
-        // Stop if no more new vertices are connected to the graph (effectively an invalid graph for Prim algorithm)
-        if (to == UINT32_MAX) throw std::runtime_error("The graph is not fully connected, Prim's algorithm cannot be applied.");
-        // Include the closest vertex in the MST
-        inMST[to] = true;
+        // If no vertex is connected to the MST anymore, start a new tree (of the spanning forest) from the first vertex left
+        if (to == UINT32_MAX) {
+            while (inMST[nextRoot]) nextRoot++;
+            to = nextRoot;
+        }
 
-        // Update distance and parent for the adjacent vertices of the picked vertex
-        for (uint32_t from = 0; from < size; from++) {
-            if (data[from][to] != 0 && !inMST[from] && data[from][to] < distance[from]) {
-                distance[from] = data[from][to];
-                parent[from] = to;
-            }
+        // Include the closest vertex in the MST, with the edge to its parent (in both directions, as the MST is undirected)
+        inMST[to] = true;
+        if (parent[to] != UINT32_MAX) {
+            edges.push_back({parent[to], to, distance[to]});
+            edges.push_back({to, parent[to], distance[to]});
         }
-    }
 
-    // Build the MST from the parents
-    for (uint32_t to = 1; to < size; to++) {  // Start from the first child
-        uint32_t from = parent[to];
-        int64_t distance = data[from][to];
-        mstData[from][to] = distance;
-        mstData[to][from] = distance;  // Undirected graph
+        // Update distance and parent for the adjacent vertices of the picked vertex (the ones with an edge from or to it)
+        auto update = [&](uint32_t other, int64_t weight) {
+            if (weight == INT64_MAX) return;  // Infinite weights are not edges
+            if (!inMST[other] && weight < distance[other]) {
+                distance[other] = weight;
+                parent[other] = to;
+            }
+        };
+        visitCells([&](auto cells) { cells.forEachInRow(to, update); });
+        visitReverseCells([&](auto reverseCells) { reverseCells.forEachInRow(to, update); });
     }
 
     delete[] inMST;
     delete[] distance;
     delete[] parent;
 
-    return new Matrice(size, mstData);  // Uses the private constructor (faster)
+    if (progress.stopped()) throw CancelledError();
+    progress.report(size);
+    return new Matrice(size, edges);  // Uses the private constructor (chooses the most compact layout)
 }
 
-std::vector<std::vector<uint32_t>> Matrice::kosaraju() const
+template<typename T, typename Progress>
+Matrice* Matrice::densePrim(SimdLevel level, Progress& progress) const
 {
-    // Initialize all necessary variables
-    uint32_t** ordering = new uint32_t*[size];
-    bool* visited = new bool[size];
-    for (uint32_t i = 0; i < size; i++) {
-        visited[i] = false;
-    }
-    uint32_t* postCount = new uint32_t(0);
+    const PrimRelaxKernel<T> relax = primRelaxKernel<T>(level);
+    const PrimArgminKernel closest = primArgminKernel(level);
+    const T* cells = static_cast<const T*>(data);
+    const bool oriented = isOriented();
+    if (oriented) transpose();
+    const T* columns = static_cast<const T*>(transposedData);
+
+    // The nodes in the MST are at distance INT64_MIN, so that the kernels skip them without checking a separate array
+    std::vector<int64_t> distance(size, INT64_MAX);
+    std::vector<uint32_t> parent(size, UINT32_MAX);
+    std::vector<Edge> edges;
+    edges.reserve(2 * static_cast<size_t>(size));
+    for (uint32_t _ = 0; _ < size; _++) {  // Each iteration adds a vertex to the MST
+        if (!progress.report(_)) throw CancelledError();
 
-    // Perform the first DFS (until all nodes are visited)
-    while (*postCount < size) {
-        // Find the next unvisited node
-        uint32_t next = 0;
-        while (next < size && visited[next]) {
-            next++;
+        // The closest vertex, or the first vertex left if none is connected to the MST (starting a new tree of the spanning forest)
+        uint32_t to = closest(distance.data(), size);
+        if (parent[to] != UINT32_MAX) {
+            edges.push_back({parent[to], to, distance[to]});
+            edges.push_back({to, parent[to], distance[to]});
         }
+        distance[to] = INT64_MIN;
 
-        // Perform a DFS from that node
-        dfs(next, ordering, visited, nullptr, postCount);
+        // Update distance and parent for the adjacent vertices of the picked vertex: its row, then its column if the graph is oriented
+        // (the row of the transposed matrix, so that both are read in order by the kernel)
+        relax(distance.data(), parent.data(), cells + static_cast<size_t>(to) * stride, to, size);
+        if (oriented) relax(distance.data(), parent.data(), columns + static_cast<size_t>(to) * stride, to, size);
     }
+    progress.report(size);
+    return new Matrice(size, edges);  // Uses the private constructor (chooses the most compact layout)
+}
 
-    // Initialize/reset values for the clusters calculation
-    std::vector<std::vector<uint32_t>> clusters;
-    for (uint32_t i = 0; i < size; i++) {
-        visited[i] = false;
+Matrice* Matrice::heapPrim(const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return heapPrim(progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::heapPrim(Progress& progress) const
+{
+    std::vector<bool> inMST(size, false);
+    std::vector<uint32_t> parent(size, UINT32_MAX);
+    DaryHeap<int64_t> heap(size);
+
+    std::vector<Edge> edges;
+    edges.reserve(2 * static_cast<size_t>(size));
+    uint32_t added = 0;
+    for (uint32_t root = 0; root < size; root++) {
+        // Start a new tree (of the spanning forest) from each vertex not connected to the previous ones
+        if (inMST[root]) continue;
+        heap.push(root, 0);
+
+        while (!heap.empty()) {
+            // Include the closest vertex in the MST, with the edge to its parent (its key in the heap)
+            if (!progress.report(added++)) throw CancelledError();
+            uint32_t to = heap.pop();
+            inMST[to] = true;
+            if (parent[to] != UINT32_MAX) {
+                edges.push_back({parent[to], to, heap.key(to)});
+                edges.push_back({to, parent[to], heap.key(to)});
+            }
+
+            // Insert the adjacent vertices of the picked vertex in the heap, or decrease their distance
+            auto update = [&](uint32_t other, int64_t weight) {
+                if (weight == INT64_MAX || inMST[other]) return;  // Infinite weights are not edges
+                if (!heap.contains(other) || weight < heap.key(other)) {
+                    heap.push(other, weight);
+                    parent[other] = to;
+                }
+            };
+            visitCells([&](auto cells) { cells.forEachInRow(to, update); });
+            visitReverseCells([&](auto reverseCells) { reverseCells.forEachInRow(to, update); });
+        }
     }
-    *postCount = 0;
+    progress.report(size);
+    return new Matrice(size, edges);  // Uses the private constructor (chooses the most compact layout)
+}
 
-    // Perform DFS until all nodes are visited
-    while (*postCount < size) {
-        // Find the next unvisited node (the one with the highest post number)
-        uint32_t next = UINT32_MAX;
-        uint32_t maxPost = 0;
+Matrice* Matrice::kruskal(const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, 2 * static_cast<uint64_t>(size), [&](auto& progress) { return kruskal(progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::kruskal(Progress& progress) const
+{
+    // Gather the edges once per direction (the duplicates are then skipped, as their nodes are already connected), without self-loops
+    std::vector<Edge> candidates;
+    visitCells([&](auto cells) {
         for (uint32_t i = 0; i < size; i++) {
-            if (!visited[i] && ordering[i][1] >= maxPost) {  // '>=' is fine, since every post order is unique
-                next = i;
-                maxPost = ordering[i][1];
+            if (!progress.report(i)) throw CancelledError();
+            cells.forEachInRow(i, [&](uint32_t j, int64_t weight) {
+                if (weight != INT64_MAX && i != j) candidates.push_back({std::min(i, j), std::max(i, j), weight});
+            });
+        }
+    });
+
+    // Add the edges by increasing weight (the order of the nodes makes the result deterministic), unless their nodes are already connected
+    std::sort(candidates.begin(), candidates.end(), [](const Edge& a, const Edge& b) {
+        if (a.weight != b.weight) return a.weight < b.weight;
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    });
+    UnionFind components(size);
+    std::vector<Edge> edges;
+    edges.reserve(2 * static_cast<size_t>(size));
+    for (const Edge& edge : candidates) {
+        if (edges.size() + 2 >= 2 * static_cast<size_t>(size)) break;  // A spanning tree has n-1 edges
+        if (!components.unite(edge.from, edge.to)) continue;
+        if (!progress.report(size + edges.size() / 2)) throw CancelledError();
+        edges.push_back(edge);
+        edges.push_back({edge.to, edge.from, edge.weight});
+    }
+    progress.report(2 * static_cast<uint64_t>(size));
+    return new Matrice(size, edges);  // Uses the private constructor (chooses the most compact layout)
+}
+
+Matrice* Matrice::boruvka(uint32_t threads, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return boruvka(threads, progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::boruvka(uint32_t threads, Progress& progress) const
+{
+    ThreadPool* ownPool = threads != 0 ? new ThreadPool(threads) : nullptr;
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+
+    // Gather the edges once per direction, without self-loops, each block of rows on a thread
+    // (the blocks are concatenated in order, so the edges are in the same order whatever the number of threads)
+    uint32_t rowBlocks = std::min(size, 8 * pool.getThreadCount());
+    std::vector<std::vector<Edge>> blockCandidates(rowBlocks);
+    pool.parallelFor(rowBlocks, [&](uint64_t block) {
+        uint32_t begin = static_cast<uint64_t>(size) * block / rowBlocks;
+        uint32_t end = static_cast<uint64_t>(size) * (block + 1) / rowBlocks;
+        visitCells([&](auto cells) {
+            for (uint32_t i = begin; i < end; i++) {
+                cells.forEachInRow(i, [&](uint32_t j, int64_t weight) {
+                    if (weight != INT64_MAX && i != j) blockCandidates[block].push_back({std::min(i, j), std::max(i, j), weight});
+                });
+            }
+        });
+    });
+    std::vector<Edge> candidates;
+    for (std::vector<Edge>& block : blockCandidates) {
+        candidates.insert(candidates.end(), block.begin(), block.end());
+        std::vector<Edge>().swap(block);
+    }
+
+    // The edges are ordered by weight, then by index: with this total order, the cheapest edges of the components never form a cycle
+    const uint64_t none = UINT64_MAX;
+    auto lighter = [&](uint64_t a, uint64_t b) {
+        return candidates[a].weight != candidates[b].weight ? candidates[a].weight < candidates[b].weight : a < b;
+    };
+    std::vector<std::atomic<uint64_t>> cheapest(size);
+    for (std::atomic<uint64_t>& edge : cheapest) edge.store(none, std::memory_order_relaxed);
+    auto offer = [&](uint32_t component, uint64_t edge) {
+        uint64_t current = cheapest[component].load(std::memory_order_relaxed);
+        while ((current == none || lighter(edge, current))
+               && !cheapest[component].compare_exchange_weak(current, edge, std::memory_order_relaxed)) {}
+    };
+
+    ConcurrentUnionFind components(size);
+    std::vector<Edge> edges;
+    edges.reserve(2 * static_cast<size_t>(size));
+    std::vector<Edge> remaining;
+    const uint64_t nodeChunks = (size + BORUVKA_CHUNK_SIZE - 1) / BORUVKA_CHUNK_SIZE;
+    std::vector<std::vector<Edge>> added(nodeChunks);
+    while (!candidates.empty() && progress.report(edges.size() / 2)) {
+        const uint64_t chunks = (candidates.size() + BORUVKA_CHUNK_SIZE - 1) / BORUVKA_CHUNK_SIZE;
+        auto chunkEnd = [&](uint64_t chunk) { return std::min<uint64_t>(candidates.size(), (chunk + 1) * BORUVKA_CHUNK_SIZE); };
+
+        // Find the cheapest edge leaving each component (the components do not change during this step)
+        pool.parallelFor(chunks, [&](uint64_t chunk) {
+            for (uint64_t index = chunk * BORUVKA_CHUNK_SIZE; index < chunkEnd(chunk); index++) {
+                uint32_t a = components.find(candidates[index].from);
+                uint32_t b = components.find(candidates[index].to);
+                if (a == b) continue;
+                offer(a, index);
+                offer(b, index);
             }
+        });
+
+        // Merge the components along their cheapest edge (an edge chosen by both of its components is only added once)
+        pool.parallelFor(nodeChunks, [&](uint64_t chunk) {
+            uint32_t end = std::min<uint64_t>(size, (chunk + 1) * BORUVKA_CHUNK_SIZE);
+            for (uint32_t component = chunk * BORUVKA_CHUNK_SIZE; component < end; component++) {
+                uint64_t index = cheapest[component].exchange(none, std::memory_order_relaxed);
+                if (index == none || !components.unite(candidates[index].from, candidates[index].to)) continue;
+                added[chunk].push_back(candidates[index]);
+            }
+        });
+        bool merged = false;
+        for (std::vector<Edge>& chunkEdges : added) {
+            for (const Edge& edge : chunkEdges) {
+                edges.push_back(edge);
+                edges.push_back({edge.to, edge.from, edge.weight});
+            }
+            merged |= !chunkEdges.empty();
+            chunkEdges.clear();
         }
+        if (!merged || edges.size() + 2 >= 2 * static_cast<size_t>(size)) break;  // No edge leaves the components, or a spanning tree is found
 
-        // Collect the cluster from that node
-        std::vector<uint32_t> currentCluster;
-        dfsCollect(next, &currentCluster, visited, nullptr, postCount);
-        clusters.push_back(currentCluster);
+        // Drop the edges now inside a component: each chunk is compacted in place, then copied after the previous ones
+        std::vector<uint64_t> kept(chunks + 1, 0);
+        pool.parallelFor(chunks, [&](uint64_t chunk) {
+            uint64_t next = chunk * BORUVKA_CHUNK_SIZE;
+            for (uint64_t index = next; index < chunkEnd(chunk); index++) {
+                if (components.find(candidates[index].from) != components.find(candidates[index].to)) candidates[next++] = candidates[index];
+            }
+            kept[chunk + 1] = next - chunk * BORUVKA_CHUNK_SIZE;
+        });
+        for (uint64_t chunk = 0; chunk < chunks; chunk++) kept[chunk + 1] += kept[chunk];
+        remaining.resize(kept[chunks]);
+        pool.parallelFor(chunks, [&](uint64_t chunk) {
+            auto begin = candidates.begin() + chunk * BORUVKA_CHUNK_SIZE;
+            std::copy(begin, begin + (kept[chunk + 1] - kept[chunk]), remaining.begin() + kept[chunk]);
+        });
+        candidates.swap(remaining);
     }
+    delete ownPool;
 
-    // Free the resources
-    for (uint32_t i = 0; i < size; i++) {
-        delete[] ordering[i];
+    if (progress.stopped()) throw CancelledError();
+    progress.report(size);
+    return new Matrice(size, edges);  // Uses the private constructor (chooses the most compact layout)
+}
+
+Matrice::SpanningTreeEngine Matrice::spanningTreeEngine() const
+{
+    // Compare the estimated costs (in cells read in order), the edges of a node being found by reading its row and column unless the matrix is sparse
+    int64_t minWeight, maxWeight;
+    uint64_t edges;
+    weightRange(&minWeight, &maxWeight, &edges);
+    double cells = static_cast<double>(size) * size;
+    double scanCost = layout == Layout::Sparse ? static_cast<double>(edges) : cells;
+    double rowsAndColumnsCost = (PRIM_CELL_COST + PRIM_COLUMN_COST) * cells;
+    double primCost = layout == Layout::Dense && !isOriented() ? PRIM_CELL_COST * cells : rowsAndColumnsCost;
+    double heapPrimCost = (layout == Layout::Sparse ? 0.0 : rowsAndColumnsCost) + PRIM_HEAP_EDGE_COST * std::log2(size + 1.0) * edges;
+    double kruskalCost = scanCost + KRUSKAL_EDGE_COST * std::log2(edges + 1.0) * edges;
+    double boruvkaCost = (scanCost + BORUVKA_EDGE_COST * std::log2(size + 1.0) * edges) / ThreadPool::shared().getThreadCount();
+    if (boruvkaCost < std::min({primCost, heapPrimCost, kruskalCost})) return SpanningTreeEngine::Boruvka;
+    if (kruskalCost < primCost && kruskalCost < heapPrimCost) return SpanningTreeEngine::Kruskal;
+    return heapPrimCost < primCost ? SpanningTreeEngine::HeapPrim : SpanningTreeEngine::Prim;
+}
+
+Matrice* Matrice::minimumSpanningTree(SpanningTreeEngine* engine, const ProgressHooks* hooks) const
+{
+    SpanningTreeEngine chosen = spanningTreeEngine();
+    if (engine != nullptr) *engine = chosen;
+    switch (chosen) {
+        case SpanningTreeEngine::HeapPrim: return heapPrim(hooks);
+        case SpanningTreeEngine::Kruskal:  return kruskal(hooks);
+        case SpanningTreeEngine::Boruvka:  return boruvka(0, hooks);
+        default:                           return prim(simdLevel(), hooks);
     }
-    delete[] ordering;
-    delete[] visited;
-    delete postCount;
+}
 
+const char* Matrice::spanningTreeEngineName(SpanningTreeEngine engine)
+{
+    switch (engine) {
+        case SpanningTreeEngine::HeapPrim: return "Prim (heap)";
+        case SpanningTreeEngine::Kruskal:  return "Kruskal";
+        case SpanningTreeEngine::Boruvka:  return "Borůvka";
+        default:                           return "Prim (array)";
+    }
+}
+
+std::vector<std::vector<uint32_t>> Matrice::tarjan(const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return tarjan(progress); });
+}
+
+template<typename Progress>
+std::vector<std::vector<uint32_t>> Matrice::tarjan(Progress& progress) const
+{
+    // The rank of each node: 0 until it is visited, then its visit rank, lowered to the rank of the oldest node of the path it reaches,
+    // and finally the number of its cluster. Ranks are given back when a cluster is done, while clusters are numbered down from size - 1:
+    // a node of a finished cluster always has a higher rank than the nodes being visited, so it never lowers them
+    std::vector<uint32_t> rank(size, 0);
+    std::vector<bool> isRoot(size, false);  // Whether a node is still the oldest node of its cluster (its rank was not lowered)
+    std::vector<uint32_t> pending;  // The nodes visited whose cluster is not done yet
+    pending.reserve(size);
+    struct Frame {
+        uint32_t node;
+        uint64_t position;  // Where to resume the walk of its row (see `nextInRow`)
+    };
+    std::vector<Frame> path;  // The nodes being visited, in place of the call stack of a recursive search
+    path.reserve(size);
+
+    uint32_t nextRank = 1;
+    uint32_t cluster = size;
+    uint32_t visited = 0;  // The number of nodes visited (ranks are given back, so it is counted apart)
+    visitCells([&](auto cells) {
+        for (uint32_t start = 0; start < size; start++) {
+            if (rank[start] != 0) continue;
+            if (!progress.report(visited++)) throw CancelledError();
+            rank[start] = nextRank++;
+            isRoot[start] = true;
+            path.push_back({start, 0});
+
+            while (!path.empty()) {
+                // Go on with the successors of the deepest node, until a new one (visited first, as the recursive search would).
+                // The ones already visited only lower its rank, so they are walked in a tight loop
+                uint32_t node = path.back().node;
+                uint64_t position = path.back().position;
+                uint32_t lowest = rank[node];
+                uint32_t successor;
+                while ((successor = cells.nextInRow(node, position)) < size && rank[successor] != 0) {
+                    lowest = std::min(lowest, rank[successor]);
+                }
+                path.back().position = position;
+                if (lowest < rank[node]) {
+                    rank[node] = lowest;
+                    isRoot[node] = false;
+                }
+                if (successor < size) {
+                    if (!progress.report(visited++)) throw CancelledError();
+                    rank[successor] = nextRank++;
+                    isRoot[successor] = true;
+                    path.push_back({successor, 0});
+                    continue;
+                }
+
+                // Every successor is visited: the node closes its cluster if it is its oldest node, with the pending nodes visited after it
+                path.pop_back();
+                if (isRoot[node]) {
+                    cluster--;
+                    nextRank--;
+                    while (!pending.empty() && rank[node] <= rank[pending.back()]) {
+                        rank[pending.back()] = cluster;
+                        pending.pop_back();
+                        nextRank--;
+                    }
+                    rank[node] = cluster;
+                } else {
+                    pending.push_back(node);
+                }
+
+                // Back in the parent, as after the recursive call
+                if (!path.empty() && rank[node] < rank[path.back().node]) {
+                    rank[path.back().node] = rank[node];
+                    isRoot[path.back().node] = false;
+                }
+            }
+        }
+    });
+
+    // The clusters are done in reverse topological order, so they are numbered in topological order from `cluster`.
+    // Walking the nodes in order fills each cluster in increasing order
+    std::vector<uint32_t> clusterSizes(size - cluster, 0);
+    for (uint32_t node = 0; node < size; node++) clusterSizes[rank[node] - cluster]++;
+    std::vector<std::vector<uint32_t>> clusters(size - cluster);
+    for (uint32_t i = 0; i < clusters.size(); i++) clusters[i].reserve(clusterSizes[i]);
+    for (uint32_t node = 0; node < size; node++) clusters[rank[node] - cluster].push_back(node);
+    progress.report(size);
     return clusters;
 }
 
-Matrice* Matrice::clusterMatrice() const
+std::vector<std::vector<uint32_t>> Matrice::forwardBackward(uint32_t threads, const ProgressHooks* hooks) const
 {
-    // Get the clusters using Kosaraju's algorithm
-    std::vector<std::vector<uint32_t>> clusters = kosaraju();
-    uint32_t clustersCount = clusters.size();
+    return runWithProgress(hooks, size, [&](auto& progress) { return forwardBackward(threads, progress); });
+}
 
-    // Create a new adjacency matrix for the clusters
-    int64_t** clustersData = new int64_t*[clustersCount];
-    for (uint32_t i = 0; i < clustersCount; i++) {
-        clustersData[i] = new int64_t[clustersCount];
-        for (uint32_t j = 0; j < clustersCount; j++) {
-            clustersData[i][j] = 0;  // Initialize empty
+template<typename Progress>
+std::vector<std::vector<uint32_t>> Matrice::forwardBackward(uint32_t threads, Progress& progress) const
+{
+    if (size == 0) return {};
+    ThreadPool* ownPool = threads != 0 ? new ThreadPool(threads) : nullptr;
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::shared();
+
+    // The subgraphs split at each round form a tree, where no edge goes from a child to a previous one (see the parts below):
+    // its leaves are the clusters, and listing them depth-first gives a topological order
+    struct Slot {
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;  // 0 for the leaves, which are either a cluster or trimmed nodes (each being a cluster)
+    };
+    enum Part : uint8_t { Sources, Backward, Cluster, Unreached, Forward, Sinks, Rest, Undecided };
+    const uint8_t parts = Rest;  // The parts of a forward-backward round, in order (a coloring round has a cluster and a rest per color)
+    std::vector<Slot> slots(1);  // The root holds every node
+    std::vector<uint32_t> slot(size, 0);  // The subgraph of each node
+    std::vector<uint32_t> label(size);  // The cluster of each node, given by one of its nodes
+    std::vector<uint8_t> part(size);  // The part of each node left, in the current round
+    std::vector<std::atomic<uint8_t>> reached(size);  // Whether each node left was reached forward (1), backward (2), and is queued (4)
+    std::vector<std::atomic<uint32_t>> color(size);  // The largest node reaching each node left in its subgraph (coloring rounds)
+    std::vector<uint32_t> rootRank(size);  // The rank of each color in the current round (coloring rounds)
+    std::vector<uint32_t> active(size);  // The nodes left
+    for (uint32_t node = 0; node < size; node++) active[node] = node;
+    std::vector<uint32_t> activeSlots{0};  // The subgraphs left
+    std::vector<uint32_t> slotIndex{0};  // The index of each subgraph left in `activeSlots`
+
+    // Rows are read by blocks of nodes, the calling thread reading a single block alone (ex. the frontier of a search along a path)
+    uint64_t rowLength = layout == Layout::Sparse ? 1 + sparse.offsets[size] / size : layout == Layout::Bits ? stride : size;
+    uint64_t nodesPerChunk = std::max<uint64_t>(1, FORWARD_BACKWARD_CHUNK_SIZE / rowLength);
+    auto chunkCount = [&](uint64_t count) { return (count + nodesPerChunk - 1) / nodesPerChunk; };
+    auto forChunks = [&](uint64_t count, const std::function<void(uint64_t, uint64_t, uint64_t)>& function) {
+        auto run = [&](uint64_t chunk) { function(chunk, chunk * nodesPerChunk, std::min(count, (chunk + 1) * nodesPerChunk)); };
+        uint64_t chunks = chunkCount(count);
+        if (chunks == 1) run(0);
+        else if (chunks > 1) pool.parallelFor(chunks, run);
+    };
+    auto concatenate = [](const std::vector<std::vector<uint32_t>>& lists) {
+        std::vector<uint32_t> result;
+        for (const std::vector<uint32_t>& list : lists) result.insert(result.end(), list.begin(), list.end());
+        return result;
+    };
+
+    visitCellsAndTranspose([&](auto cells, auto reverseCells) {
+        // Visit the nodes of a frontier, and then the nodes they add, until there is none left (the order does not matter).
+        // Large frontiers are visited a level at a time, by blocks on every thread, and small ones by the calling thread alone,
+        // as a stack, until they grow again (ex. a search along a path)
+        auto propagate = [&](std::vector<uint32_t> frontier, const auto& visit) {
+            while (!frontier.empty()) {
+                if (frontier.size() <= nodesPerChunk) {
+                    while (!frontier.empty() && frontier.size() <= 2 * nodesPerChunk) {
+                        uint32_t node = frontier.back();
+                        frontier.pop_back();
+                        visit(node, frontier);
+                    }
+                    continue;
+                }
+                std::vector<std::vector<uint32_t>> next(chunkCount(frontier.size()));
+                forChunks(frontier.size(), [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+                    for (uint64_t k = begin; k < end; k++) visit(frontier[k], next[chunk]);
+                });
+                frontier = concatenate(next);
+            }
+        };
+
+        // Walk the nodes reached from the sources (marking them with the given bit), through the edges accepted by `follow`,
+        // without leaving the subgraph and skipping the nodes already in a part
+        auto search = [&](const auto& accessor, uint8_t bit, const std::vector<uint32_t>& sources, const auto& follow) {
+            for (uint32_t node : sources) reached[node].fetch_or(bit, std::memory_order_relaxed);
+            propagate(sources, [&](uint32_t node, std::vector<uint32_t>& next) {
+                accessor.forEachInRow(node, [&](uint32_t other, int64_t) {
+                    if (slot[other] != slot[node] || part[other] != Undecided || !follow(node, other)) return;
+                    if (reached[other].load(std::memory_order_relaxed) & bit) return;
+                    if (!(reached[other].fetch_or(bit, std::memory_order_relaxed) & bit)) next.push_back(other);
+                });
+            });
+        };
+
+        // Forward-backward rounds split the large clusters off, and coloring rounds the many small ones: they are alternated,
+        // so that neither kind of graph needs many rounds
+        for (uint32_t round = 0; !active.empty() && progress.report(size - active.size()); round++) {
+            const bool coloring = round % 2 == 1;
+            const uint32_t slotsLeft = activeSlots.size();
+            std::vector<std::atomic<uint8_t>> trimmed(2 * static_cast<size_t>(slotsLeft));  // Whether each subgraph has sources, sinks (value-initialized to 0)
+            std::vector<std::atomic<uint64_t>> pivots(coloring ? 0 : slotsLeft);  // The smallest key (hash, then node) of each subgraph
+            for (std::atomic<uint64_t>& pivot : pivots) pivot.store(UINT64_MAX, std::memory_order_relaxed);
+
+            // Trim the nodes without predecessor or successor in their subgraph, and prepare the other ones for the searches:
+            // as pivots, a fixed hash spreads them over the subgraph (so that it is usually split in large parts), and as colors, each node has its own
+            std::vector<std::vector<uint32_t>> undecided(chunkCount(active.size()));
+            forChunks(active.size(), [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+                for (uint64_t k = begin; k < end; k++) {
+                    uint32_t node = active[k];
+                    uint32_t index = slotIndex[slot[node]];
+                    auto linked = [&](const auto& accessor) {
+                        uint64_t position = 0;
+                        uint32_t other;
+                        while ((other = accessor.nextInRow(node, position)) < size) {
+                            if (other != node && slot[other] == slot[node]) return true;
+                        }
+                        return false;
+                    };
+                    part[node] = !linked(reverseCells) ? Sources : !linked(cells) ? Sinks : Undecided;
+                    if (part[node] != Undecided) {
+                        label[node] = node;
+                        trimmed[2 * index + (part[node] == Sinks)].store(1, std::memory_order_relaxed);
+                    } else if (coloring) {
+                        color[node].store(node, std::memory_order_relaxed);
+                        reached[node].store(4, std::memory_order_relaxed);
+                        undecided[chunk].push_back(node);
+                    } else {
+                        reached[node].store(0, std::memory_order_relaxed);
+                        uint64_t key = static_cast<uint64_t>(node * 2654435761u) << 32 | node;
+                        uint64_t current = pivots[index].load(std::memory_order_relaxed);
+                        while (key < current && !pivots[index].compare_exchange_weak(current, key, std::memory_order_relaxed)) {}
+                    }
+                }
+            });
+
+            // Find the part of each node left, and the children of each subgraph, in order (`childOf` gives the child of each part)
+            std::vector<uint32_t> childOf;
+            std::vector<uint32_t> nextSlots;
+            auto addChild = [&](uint32_t position, bool left) {
+                childOf[position] = slots.size();
+                if (left) nextSlots.push_back(slots.size());
+                slots.emplace_back();
+            };
+            if (!coloring) {
+                // Search forward and backward from the pivot of each subgraph, all at once, and split the nodes by the searches reaching them.
+                // The nodes reaching the pivot come before its cluster, and the ones it reaches after it, with the unreached ones
+                // in between (they can only be reached from the former, and only reach the latter)
+                std::vector<uint32_t> sources;
+                for (uint32_t index = 0; index < slotsLeft; index++) {
+                    uint64_t key = pivots[index].load(std::memory_order_relaxed);
+                    if (key != UINT64_MAX) sources.push_back(static_cast<uint32_t>(key));
+                }
+                auto any = [](uint32_t, uint32_t) { return true; };
+                search(cells, 1, sources, any);
+                search(reverseCells, 2, sources, any);
+
+                std::vector<std::atomic<uint8_t>> used(parts * static_cast<size_t>(slotsLeft));  // Whether each part is not empty (value-initialized to 0)
+                forChunks(active.size(), [&](uint64_t, uint64_t begin, uint64_t end) {
+                    static const Part byReached[4] = {Unreached, Forward, Backward, Cluster};
+                    for (uint64_t k = begin; k < end; k++) {
+                        uint32_t node = active[k];
+                        uint32_t index = slotIndex[slot[node]];
+                        if (part[node] == Undecided) {
+                            part[node] = byReached[reached[node].load(std::memory_order_relaxed)];
+                            if (part[node] == Cluster) label[node] = static_cast<uint32_t>(pivots[index].load(std::memory_order_relaxed));
+                        }
+                        used[parts * index + part[node]].store(1, std::memory_order_relaxed);
+                    }
+                });
+
+                childOf.resize(parts * static_cast<size_t>(slotsLeft));
+                for (uint32_t index = 0; index < slotsLeft; index++) {
+                    uint32_t parent = activeSlots[index];
+                    slots[parent].firstChild = slots.size();
+                    for (uint8_t p = 0; p < parts; p++) {
+                        if (used[parts * index + p].load(std::memory_order_relaxed)) addChild(parts * index + p, p == Backward || p == Unreached || p == Forward);
+                    }
+                    slots[parent].childCount = slots.size() - slots[parent].firstChild;
+                }
+            } else {
+                // Give each node the largest node reaching it in its subgraph (its color). Edges never go to a smaller color, so the colors
+                // are ordered by increasing value, and each one is reached from its node: the nodes of the color reaching it are its cluster,
+                // and the other ones come after it
+                propagate(concatenate(undecided), [&](uint32_t node, std::vector<uint32_t>& next) {
+                    // Unqueue the node before reading its color: a node raising it later queues it again
+                    reached[node].fetch_and(~4);
+                    uint32_t nodeColor = color[node].load();
+                    cells.forEachInRow(node, [&](uint32_t other, int64_t) {
+                        if (slot[other] != slot[node] || part[other] != Undecided) return;
+                        uint32_t current = color[other].load(std::memory_order_relaxed);
+                        bool raised = false;
+                        while (nodeColor > current && !(raised = color[other].compare_exchange_weak(current, nodeColor))) {}
+                        if (raised && !(reached[other].fetch_or(4) & 4)) next.push_back(other);
+                    });
+                });
+
+                // Search backward from the node of each color, staying in its color
+                std::vector<std::vector<uint32_t>> rootLists(chunkCount(active.size()));
+                forChunks(active.size(), [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+                    for (uint64_t k = begin; k < end; k++) {
+                        uint32_t node = active[k];
+                        if (part[node] == Undecided && color[node].load(std::memory_order_relaxed) == node) rootLists[chunk].push_back(node);
+                    }
+                });
+                std::vector<uint32_t> roots = concatenate(rootLists);
+                search(reverseCells, 2, roots, [&](uint32_t node, uint32_t other) {
+                    return color[other].load(std::memory_order_relaxed) == color[node].load(std::memory_order_relaxed);
+                });
+
+                // Rank the colors by subgraph, then by value
+                std::sort(roots.begin(), roots.end(), [&](uint32_t a, uint32_t b) {
+                    uint32_t indexA = slotIndex[slot[a]], indexB = slotIndex[slot[b]];
+                    return indexA != indexB ? indexA < indexB : a < b;
+                });
+                for (uint32_t rank = 0; rank < roots.size(); rank++) rootRank[roots[rank]] = rank;
+                std::vector<std::atomic<uint8_t>> restUsed(roots.size());  // Whether each color has nodes out of its cluster (value-initialized to 0)
+                forChunks(active.size(), [&](uint64_t, uint64_t begin, uint64_t end) {
+                    for (uint64_t k = begin; k < end; k++) {
+                        uint32_t node = active[k];
+                        if (part[node] != Undecided) continue;
+                        label[node] = color[node].load(std::memory_order_relaxed);
+                        part[node] = reached[node].load(std::memory_order_relaxed) & 2 ? Cluster : Rest;
+                        if (part[node] == Rest) restUsed[rootRank[label[node]]].store(1, std::memory_order_relaxed);
+                    }
+                });
+
+                // The sources and sinks of each subgraph are at 2 * index and 2 * index + 1, and the cluster and the rest of each color after them
+                childOf.resize(2 * (static_cast<size_t>(slotsLeft) + roots.size()));
+                uint32_t rank = 0;
+                for (uint32_t index = 0; index < slotsLeft; index++) {
+                    uint32_t parent = activeSlots[index];
+                    slots[parent].firstChild = slots.size();
+                    if (trimmed[2 * index].load(std::memory_order_relaxed)) addChild(2 * index, false);
+                    for (; rank < roots.size() && slotIndex[slot[roots[rank]]] == index; rank++) {
+                        addChild(2 * (slotsLeft + rank), false);
+                        if (restUsed[rank].load(std::memory_order_relaxed)) addChild(2 * (slotsLeft + rank) + 1, true);
+                    }
+                    if (trimmed[2 * index + 1].load(std::memory_order_relaxed)) addChild(2 * index + 1, false);
+                    slots[parent].childCount = slots.size() - slots[parent].firstChild;
+                }
+            }
+            slotIndex.resize(slots.size());
+            for (uint32_t index = 0; index < nextSlots.size(); index++) slotIndex[nextSlots[index]] = index;
+
+            // Move the nodes to their part, keeping the ones left for the next round
+            std::vector<std::vector<uint32_t>> left(chunkCount(active.size()));
+            forChunks(active.size(), [&](uint64_t chunk, uint64_t begin, uint64_t end) {
+                for (uint64_t k = begin; k < end; k++) {
+                    uint32_t node = active[k];
+                    uint32_t index = slotIndex[slot[node]];
+                    uint8_t nodePart = part[node];
+                    if (!coloring) slot[node] = childOf[parts * index + nodePart];
+                    else if (nodePart == Sources || nodePart == Sinks) slot[node] = childOf[2 * index + (nodePart == Sinks)];
+                    else slot[node] = childOf[2 * (slotsLeft + rootRank[label[node]]) + (nodePart == Rest)];
+                    if (nodePart == Backward || nodePart == Unreached || nodePart == Forward || nodePart == Rest) left[chunk].push_back(node);
+                }
+            });
+            active = concatenate(left);
+            activeSlots.swap(nextSlots);
         }
+    });
+    delete ownPool;
+    if (progress.stopped()) throw CancelledError();
+
+    // List the leaves of the tree in order (depth-first), then sort the nodes by leaf, keeping them in increasing order
+    std::vector<uint32_t> leafRank(slots.size());
+    uint32_t leaves = 0;
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        if (slots[current].childCount == 0) leafRank[current] = leaves++;
+        for (uint32_t child = slots[current].childCount; child-- > 0;) stack.push_back(slots[current].firstChild + child);
+    }
+    std::vector<uint32_t> leafStart(leaves + 1, 0);
+    for (uint32_t node = 0; node < size; node++) leafStart[leafRank[slot[node]] + 1]++;
+    for (uint32_t leaf = 0; leaf < leaves; leaf++) leafStart[leaf + 1] += leafStart[leaf];
+    std::vector<uint32_t> sorted(size);
+    for (uint32_t node = 0; node < size; node++) sorted[leafStart[leafRank[slot[node]]]++] = node;
+
+    // A leaf is either a cluster, or trimmed nodes which are each a cluster (with different labels)
+    std::vector<std::vector<uint32_t>> clusters;
+    for (uint32_t k = 0; k < size; k++) {
+        if (k == 0 || slot[sorted[k]] != slot[sorted[k - 1]] || label[sorted[k]] != label[sorted[k - 1]]) clusters.emplace_back();
+        clusters.back().push_back(sorted[k]);
     }
+    progress.report(size);
+    return clusters;
+}
+
+Matrice::SccEngine Matrice::sccEngine() const
+{
+    // Both engines read every row (about once per round for the forward-backward algorithm), so it is only chosen when shared
+    // by enough threads, and if the graph has enough cells (or edges) for each thread to read a block
+    uint32_t threads = ThreadPool::shared().getThreadCount();
+    uint64_t cells = layout == Layout::Sparse ? size + sparse.offsets[size] : static_cast<uint64_t>(size) * size;
+    bool parallel = threads > FORWARD_BACKWARD_COST && cells >= static_cast<uint64_t>(FORWARD_BACKWARD_CHUNK_SIZE) * threads;
+    return parallel ? SccEngine::ForwardBackward : SccEngine::Tarjan;
+}
+
+std::vector<std::vector<uint32_t>> Matrice::stronglyConnectedComponents(SccEngine* engine, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return stronglyConnectedComponents(engine, progress); });
+}
+
+template<typename Progress>
+std::vector<std::vector<uint32_t>> Matrice::stronglyConnectedComponents(SccEngine* engine, Progress& progress) const
+{
+    SccEngine chosen = sccEngine();
+    if (engine != nullptr) *engine = chosen;
+    return chosen == SccEngine::ForwardBackward ? forwardBackward(0, progress) : tarjan(progress);
+}
+
+const char* Matrice::sccEngineName(SccEngine engine)
+{
+    switch (engine) {
+        case SccEngine::ForwardBackward: return "Forward-backward";
+        default:                         return "Tarjan";
+    }
+}
+
+Matrice* Matrice::clusterMatrice(SccEngine* engine, const ProgressHooks* hooks) const
+{
+    // Get the clusters (strongly connected components), then count the edges between them, as two halves of the progress
+    return runWithProgress(hooks, 2 * static_cast<uint64_t>(size), [&](auto& progress) {
+        std::vector<std::vector<uint32_t>> clusters = stronglyConnectedComponents(engine, progress);
+        progress.setOffset(size);
+        return clusterMatrice(clusters, progress);
+    });
+}
+
+Matrice* Matrice::clusterMatrice(const std::vector<std::vector<uint32_t>>& clusters, const ProgressHooks* hooks) const
+{
+    return runWithProgress(hooks, size, [&](auto& progress) { return clusterMatrice(clusters, progress); });
+}
+
+template<typename Progress>
+Matrice* Matrice::clusterMatrice(const std::vector<std::vector<uint32_t>>& clusters, Progress& progress) const
+{
+    uint32_t clustersCount = clusters.size();
 
-    // Populate the cluster adjacency matrix
-    /* Note: the complexity here is in fact O(n^2), with n the number of nodes in the original graph. Below is an example of why:
-           🟩🟩🟩🟦🟦
-           🟩🟩🟩🟦🟦
-           🟩🟩🟩🟦🟦
-           🟥🟥🟥🟨🟨
-           🟥🟥🟥🟨🟨
-       In this example, the rows/columns are those of the original matrix, and each color represents a specific cluster.
-       It's impossible to cross the same combination of nodes two times, leading to a n*n amount of combinations, and thus O(n^2) complexity. */
+    // Find the cluster of each node
+    std::vector<uint32_t> clusterOf(size);
     for (uint32_t i = 0; i < clustersCount; i++) {
-        for (uint32_t j = 0; j < clustersCount; j++) {
-            if (i == j) continue;  // No self-loops
+        for (uint32_t node : clusters[i]) {
+            clusterOf[node] = i;
+        }
+    }
 
-            // Check if there is an edge from any node in cluster i to any node in cluster j
+    // Count the edges between each pair of clusters, with a single pass over the edges of the original graph: the rows of each cluster
+    // are walked together, and the position of the edge to each cluster reached is kept until the next cluster (no self-loops)
+    /* Note: the complexity is the one of walking every row of the original graph: O(n^2) for dense and bit matrices
+       (O(n^2 / 64) words for the latter), and O(n + m) for sparse ones (m being the number of edges). */
+    std::vector<Edge> edges;
+    std::vector<uint32_t> lastFrom(clustersCount, UINT32_MAX);
+    std::vector<size_t> position(clustersCount);
+    uint32_t walked = 0;
+    visitCells([&](auto cells) {
+        for (uint32_t i = 0; i < clustersCount; i++) {
             for (uint32_t nodeFrom : clusters[i]) {
-                for (uint32_t nodeTo : clusters[j]) {
-                    clustersData[i][j] += data[nodeFrom][nodeTo] > 0 ? 1 : 0;
-                }
+                if (!progress.report(walked++)) throw CancelledError();
+                cells.forEachInRow(nodeFrom, [&](uint32_t nodeTo, int64_t weight) {
+                    uint32_t j = clusterOf[nodeTo];
+                    if (i == j || weight <= 0) return;
+                    if (lastFrom[j] != i) {
+                        lastFrom[j] = i;
+                        position[j] = edges.size();
+                        edges.push_back({i, j, 0});
+                    }
+                    edges[position[j]].weight++;
+                });
             }
         }
+    });
+
+    // Sort the edges of each cluster by destination in linear time: a stable counting sort by destination, then by source
+    for (bool bySource : {false, true}) {
+        std::vector<size_t> start(clustersCount + 1, 0);
+        for (const Edge& edge : edges) start[(bySource ? edge.from : edge.to) + 1]++;
+        for (uint32_t i = 0; i < clustersCount; i++) start[i + 1] += start[i];
+        std::vector<Edge> sorted(edges.size());
+        for (const Edge& edge : edges) sorted[start[bySource ? edge.from : edge.to]++] = edge;
+        edges.swap(sorted);
     }
 
-    // Generate names for the clusters
+    // Generate names for the clusters, listing at most CLUSTER_NAME_NODES nodes (and then the number of other nodes)
     std::string* clustersNames = new std::string[clustersCount];
     for (uint32_t i = 0; i < clustersCount; i++) {
-        clustersNames[i] = "{" + getName(clusters[i][0]);  // Start the name with the first node in the cluster, as cluster will always have at least one node
-        uint32_t clusterSize = clusters[i].size();
-        for (uint32_t j = 1; j < clusterSize; j++) {
-            clustersNames[i] += "," + getName(clusters[i][j]);
+        std::string& name = clustersNames[i];
+        uint32_t listed = std::min<uint32_t>(clusters[i].size(), CLUSTER_NAME_NODES);
+        name = "{";
+        for (uint32_t j = 0; j < listed; j++) {
+            if (j > 0) name += ',';
+            name += getName(clusters[i][j]);
         }
-        clustersNames[i] += "}";
+        if (listed < clusters[i].size()) name += ",… +" + std::to_string(clusters[i].size() - listed);
+        name += '}';
     }
 
-    return new Matrice(clustersCount, clustersData, clustersNames);  // Uses the private constructor (faster and allows for int64_t data)
+    progress.report(size);
+    return new Matrice(clustersCount, edges, clustersNames);  // Uses the private constructor (chooses the most compact layout)
 }
 
 /***********************
 | Private Constructors |
 ***********************/
 
-Matrice::Matrice(uint32_t size, int64_t** data, std::string* names):
+Matrice::Matrice(uint32_t size, Layout layout, CellType type, void* data, std::string* names):
     size(size),
+    stride(layout == Layout::Bits ? computeBitStride(size) : computeStride(size, type)),
+    layout(layout),
+    type(type),
     data(data),
     names(names)
 {}
 
+Matrice::Matrice(uint32_t size, std::vector<Edge>& edges, std::string* names):
+    size(size),
+    stride(0),
+    layout(Layout::Sparse),
+    type(CellType::Int8),
+    data(nullptr),
+    names(names)
+{
+    // Sort the edges by source then destination (unless they already are), and only keep the last of duplicates and non-zero weights
+    auto bySourceThenDestination = [](const Edge& a, const Edge& b) {
+        return a.from != b.from ? a.from < b.from : a.to < b.to;
+    };
+    if (!std::is_sorted(edges.begin(), edges.end(), bySourceThenDestination)) {
+        std::stable_sort(edges.begin(), edges.end(), bySourceThenDestination);
+    }
+    size_t count = 0;
+    for (const Edge& edge : edges) {
+        if (count > 0 && edges[count - 1].from == edge.from && edges[count - 1].to == edge.to) count--;
+        edges[count++] = edge;
+    }
+    edges.resize(count);
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [](const Edge& edge) { return edge.weight == 0; }), edges.end());
+
+    // Find the range of the weights
+    int64_t min = 0, max = 0;
+    for (const Edge& edge : edges) {
+        min = std::min(min, edge.weight);
+        max = std::max(max, edge.weight);
+    }
+
+    // Sparse graphs are stored as such
+    if (static_cast<uint64_t>(edges.size()) * SPARSE_RATIO < static_cast<uint64_t>(size) * size) {
+        storeSparse(edges, fittingCellType(min, max));
+        return;
+    }
+
+    // Unweighted graphs (only 0 and 1) are stored as bits
+    if (min >= 0 && max <= 1) {
+        layout = Layout::Bits;
+        stride = computeBitStride(size);
+        data = allocateBits(size);
+        BitCells cells{static_cast<uint64_t*>(data), stride, size};
+        for (const Edge& edge : edges) {
+            cells.set(edge.from, edge.to, edge.weight);
+        }
+        return;
+    }
+
+    // Other graphs are stored with the narrowest type fitting their range
+    layout = Layout::Dense;
+    type = fittingCellType(min, max);
+    stride = computeStride(size, type);
+    data = allocate(size, type);
+    dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        DenseCells<T> cells{static_cast<T*>(data), stride, size};
+        for (const Edge& edge : edges) {
+            cells.set(edge.from, edge.to, edge.weight);
+        }
+    });
+}
+
+template<typename Rows>
+void Matrice::storeCompact(Rows&& rows, int32_t min, int32_t max, uint64_t nonZero)
+{
+    // Sparse graphs are stored as such
+    if (nonZero * SPARSE_RATIO < static_cast<uint64_t>(size) * size) {
+        std::vector<Edge> edges;
+        edges.reserve(nonZero);
+        for (uint32_t i = 0; i < size; i++) {
+            const int32_t* source = rows(i);
+            for (uint32_t j = 0; j < size; j++) {
+                if (source[j] != 0) edges.push_back({i, j, source[j]});
+            }
+        }
+        storeSparse(edges, fittingCellType(min, max));
+        return;
+    }
+
+    // Unweighted graphs (only 0 and 1) are stored as bits
+    if (min >= 0 && max <= 1) {
+        layout = Layout::Bits;
+        type = CellType::Int8;
+        stride = computeBitStride(size);
+        data = allocateBits(size);
+        BitCells cells{static_cast<uint64_t*>(data), stride, size};
+        for (uint32_t i = 0; i < size; i++) {
+            const int32_t* source = rows(i);
+            uint64_t* words = cells.row(i);
+            for (uint32_t j = 0; j < size; j++) {
+                words[j >> 6] |= static_cast<uint64_t>(source[j] != 0) << (j & 63);
+            }
+        }
+        return;
+    }
+
+    // Other graphs are stored with the narrowest type fitting their range
+    layout = Layout::Dense;
+    type = fittingCellType(min, max);
+    stride = computeStride(size, type);
+    data = allocate(size, type);
+    dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        DenseCells<T> cells{static_cast<T*>(data), stride, size};
+        for (uint32_t i = 0; i < size; i++) {
+            const int32_t* source = rows(i);
+            T* row = cells.row(i);
+            for (uint32_t j = 0; j < size; j++) {
+                row[j] = static_cast<T>(source[j]);
+            }
+        }
+    });
+}
+
+void Matrice::storeSparse(const std::vector<Edge>& edges, CellType type)
+{
+    layout = Layout::Sparse;
+    this->type = type;
+    stride = 0;
+    data = nullptr;
+
+    // Allocate the rows and their transpose
+    uint64_t count = edges.size();
+    for (SparseRows* rows : {&sparse, &reverse}) {
+        rows->offsets = static_cast<uint64_t*>(allocateBytes((static_cast<size_t>(size) + 1) * sizeof(uint64_t)));
+        rows->columns = static_cast<uint32_t*>(allocateBytes(count * sizeof(uint32_t)));
+        rows->weights = allocateBytes(count * cellSize(type));
+    }
+
+    // Count the cells of each row and of each column (the offsets are shifted by one, to be turned into starts below)
+    for (const Edge& edge : edges) {
+        sparse.offsets[edge.from + 1]++;
+        reverse.offsets[edge.to + 1]++;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        sparse.offsets[i + 1] += sparse.offsets[i];
+        reverse.offsets[i + 1] += reverse.offsets[i];
+    }
+
+    // Fill the rows (edges are already sorted), then the transposed rows (a counting sort by destination keeps sources sorted)
+    dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        T* weights = static_cast<T*>(sparse.weights);
+        T* reverseWeights = static_cast<T*>(reverse.weights);
+        uint64_t* next = new uint64_t[size];
+        std::copy(reverse.offsets, reverse.offsets + size, next);
+        for (uint64_t k = 0; k < count; k++) {
+            const Edge& edge = edges[k];
+            sparse.columns[k] = edge.to;
+            weights[k] = static_cast<T>(edge.weight);
+            uint64_t position = next[edge.to]++;
+            reverse.columns[position] = edge.from;
+            reverseWeights[position] = static_cast<T>(edge.weight);
+        }
+        delete[] next;
+    });
+}
+
+void Matrice::parseText(const MappedFile& file)
+{
+    // Read the size of the matrix (first line of the file)
+    MatriceParser parser(file.getData(), file.getLength());
+    size = parser.parseSize();
+
+    // Parse the matrix data as int32_t (the type of the file values), keeping track of their range and of the number of edges
+    uint32_t fileStride = computeStride(size, CellType::Int32);
+    int32_t* fileData = static_cast<int32_t*>(allocate(size, CellType::Int32));
+    MatriceParser::Values values;
+    try {
+        values = parser.parseRows(size, fileData, fileStride);
+    } catch (...) {
+        deallocate(fileData);
+        throw;
+    }
+
+    // Store the data in the most compact way
+    storeCompact([&](uint32_t i) { return fileData + static_cast<size_t>(i) * fileStride; }, values.min, values.max, values.nonZero);
+    deallocate(fileData);
+}
+
+void Matrice::openBinary(const MappedFile& file)
+{
+    // Check the header
+    const char* base = file.getData();
+    BinaryHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.version != BINARY_VERSION) {
+        throw std::runtime_error("Unsupported binary file version " + std::to_string(header.version) + " (expected " + std::to_string(BINARY_VERSION) + ")");
+    }
+    if (header.length != file.getLength()) {
+        throw std::runtime_error("Invalid binary file: truncated or corrupted");
+    }
+    if (header.size == 0 || header.layout > static_cast<uint8_t>(Layout::Sparse) || header.type > static_cast<uint8_t>(CellType::Int64)
+        || header.cells > static_cast<uint64_t>(header.size) * header.size || header.namesOffset > header.length) {
+        throw std::runtime_error("Invalid binary file: corrupted header");
+    }
+
+    // The flags are trusted (checking them would read every cell), but must be valid values: bit matrices are never weighted
+    auto validFlag = [](uint8_t flag) { return flag == 0 || flag == 1 || flag == 255; };
+    if (!validFlag(header.oriented) || !validFlag(header.weighted)
+        || (header.layout == static_cast<uint8_t>(Layout::Bits) && header.weighted == 1)) {
+        throw std::runtime_error("Invalid binary file: corrupted header");
+    }
+    size = header.size;
+    layout = static_cast<Layout>(header.layout);
+    type = static_cast<CellType>(header.type);
+    stride = layout == Layout::Bits ? computeBitStride(size) : layout == Layout::Dense ? computeStride(size, type) : 0;
+    if (header.stride != stride) {
+        throw std::runtime_error("Invalid binary file: corrupted header");
+    }
+
+    // Find the sections, each one starting on a cache line
+    std::vector<size_t> sections = binarySections(size, layout, type, header.cells);
+    std::vector<void*> buffers;
+    uint64_t position = header.dataOffset;
+    for (size_t bytes : sections) {
+        position = (position + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+        if (position + bytes > header.length) {
+            throw std::runtime_error("Invalid binary file: truncated or corrupted");
+        }
+        buffers.push_back(const_cast<char*>(base) + position);  // The mapping is read-only, but the cells of a Matrice are never modified
+        position += bytes;
+    }
+
+    // Use the sections in place
+    if (layout == Layout::Sparse) {
+        sparse = {static_cast<uint64_t*>(buffers[0]), static_cast<uint32_t*>(buffers[1]), buffers[2]};
+        reverse = {static_cast<uint64_t*>(buffers[3]), static_cast<uint32_t*>(buffers[4]), buffers[5]};
+        // Every row must lie within the columns, and hold valid columns in increasing order, as the walks of the rows rely on it
+        for (const SparseRows* rows : {&sparse, &reverse}) {
+            bool valid = rows->offsets[0] == 0 && rows->offsets[size] == header.cells;
+            for (uint32_t i = 0; valid && i < size; i++) {
+                uint64_t begin = rows->offsets[i], end = rows->offsets[i + 1];
+                valid = begin <= end && end <= header.cells;
+                for (uint64_t k = begin; valid && k < end; k++) {
+                    valid = rows->columns[k] < size && (k == begin || rows->columns[k - 1] < rows->columns[k]);
+                }
+            }
+            if (!valid) {
+                throw std::runtime_error("Invalid binary file: corrupted sparse rows");
+            }
+        }
+    } else {
+        data = buffers[0];
+
+        // The bits after the last column of each row must be clear, as the walks of the rows read whole words
+        if (layout == Layout::Bits && size % 64 != 0) {
+            BitCells cells{static_cast<uint64_t*>(data), stride, size};
+            const uint64_t padding = ~uint64_t(0) << (size % 64);
+            for (uint32_t i = 0; i < size; i++) {
+                if ((cells.row(i)[size / 64] & padding) != 0) {
+                    throw std::runtime_error("Invalid binary file: corrupted bit rows");
+                }
+            }
+        }
+    }
+    oriented = header.oriented;
+    weighted = header.weighted;
+
+    // Read the names
+    if (header.namesOffset != 0) {
+        names = new std::string[size];
+        position = header.namesOffset;
+        for (uint32_t i = 0; i < size; i++) {
+            uint32_t nameLength = 0;
+            if (position + sizeof(nameLength) <= header.length) {
+                std::memcpy(&nameLength, base + position, sizeof(nameLength));
+            }
+            position += sizeof(nameLength);
+            if (position + nameLength > header.length) {
+                delete[] names;
+                names = nullptr;
+                throw std::runtime_error("Invalid binary file: corrupted names");
+            }
+            names[i].assign(base + position, nameLength);
+            position += nameLength;
+        }
+    }
+}
+
+std::vector<size_t> Matrice::binarySections(uint32_t size, Layout layout, CellType type, uint64_t cells)
+{
+    if (layout == Layout::Dense) {
+        return {static_cast<size_t>(size) * computeStride(size, type) * cellSize(type)};
+    }
+    if (layout == Layout::Bits) {
+        return {static_cast<size_t>(size) * computeBitStride(size) * sizeof(uint64_t)};
+    }
+    size_t offsets = (static_cast<size_t>(size) + 1) * sizeof(uint64_t);
+    size_t columns = cells * sizeof(uint32_t);
+    size_t weights = cells * cellSize(type);
+    return {offsets, columns, weights, offsets, columns, weights};
+}
+
+/****************
+| Graph Helpers |
+****************/
+
+Matrice::Adjacency Matrice::adjacency() const
+{
+    Adjacency graph;
+    graph.offsets.assign(static_cast<size_t>(size) + 1, 0);
+    visitCells([&](auto cells) {
+        for (uint32_t i = 0; i < size; i++) {
+            cells.forEachInRow(i, [&](uint32_t j, int64_t weight) {
+                if (weight == INT64_MAX) return;  // Infinite weights are not edges
+                graph.targets.push_back(j);
+                graph.weights.push_back(weight);
+            });
+            graph.offsets[i + 1] = graph.targets.size();
+        }
+    });
+    return graph;
+}
+
+void Matrice::weightRange(int64_t* minWeight, int64_t* maxWeight, uint64_t* edges) const
+{
+    int64_t min = 0, max = 0;
+    uint64_t count = 0;
+    visitCells([&](auto cells) {
+        for (uint32_t i = 0; i < size; i++) {
+            cells.forEachInRow(i, [&](uint32_t, int64_t weight) {
+                min = std::min(min, weight);
+                max = std::max(max, weight);
+                count++;
+            });
+        }
+    });
+    *minWeight = min;
+    *maxWeight = max;
+    if (edges != nullptr) *edges = count;
+}
+
+CellType Matrice::shortestPathsType(int64_t minWeight, int64_t maxWeight) const
+{
+    // The sum of two paths has at most 2 * (size - 1) edges, and a cycle (stored on the diagonal, ex. a loop of a single node)
+    // at most size edges: 2 * size bounds both. Use Int64 if it could overflow even this type
+    int64_t maxEdges = 2 * static_cast<int64_t>(size);
+    if (maxWeight != 0 && maxEdges > INT64_MAX / maxWeight) return CellType::Int64;
+    if (minWeight < -1 && maxEdges > INT64_MIN / minWeight) return CellType::Int64;  // A weight of -1 cannot overflow (but INT64_MIN / -1 does)
+    return fittingCellType(maxEdges * minWeight, maxEdges * maxWeight);
+}
+
+/*****************
+| Memory Helpers |
+*****************/
+
+void* Matrice::allocateBytes(size_t bytes)
+{
+    // Aligned on a cache line, and never empty (so that every buffer can be freed the same way)
+    void* buffer = ::operator new[](std::max<size_t>(bytes, 1), std::align_val_t(CACHE_LINE_SIZE));
+    std::memset(buffer, 0, bytes);
+    return buffer;
+}
+
+uint32_t Matrice::computeStride(uint32_t size, CellType type)
+{
+    // Round the row length up to a whole number of cache lines
+    const uint32_t cellsPerLine = CACHE_LINE_SIZE / cellSize(type);
+    return (size + cellsPerLine - 1) / cellsPerLine * cellsPerLine;
+}
+
+void* Matrice::allocate(uint32_t size, CellType type)
+{
+    // Allocate all the rows at once, aligned on a cache line
+    return allocateBytes(static_cast<size_t>(size) * computeStride(size, type) * cellSize(type));
+}
+
+uint32_t Matrice::computeBitStride(uint32_t size)
+{
+    // Round the row length up to a whole number of cache lines
+    const uint32_t wordsPerLine = CACHE_LINE_SIZE / sizeof(uint64_t);
+    uint32_t words = (size + 63) / 64;
+    return (words + wordsPerLine - 1) / wordsPerLine * wordsPerLine;
+}
+
+void* Matrice::allocateBits(uint32_t size)
+{
+    // Allocate all the rows at once, aligned on a cache line
+    return allocateBytes(static_cast<size_t>(size) * computeBitStride(size) * sizeof(uint64_t));
+}
+
+void Matrice::deallocate(void* buffer)
+{
+    if (buffer == nullptr) return;
+    ::operator delete[](buffer, std::align_val_t(CACHE_LINE_SIZE));
+}
+
 /*****************
 | Sub-Algorithms |
 *****************/
 
-void Matrice::dfs(uint32_t id, uint32_t** ordering, bool* visited,
-                  uint32_t* preCount, uint32_t* postCount) const
+uint32_t Matrice::floydWarshallTileSize(CellType type)
 {
-    // Mark the node as visited
-    visited[id] = true;
-    // Set the pre-order
-    ordering[id] = new uint32_t[2];
-    if (preCount != nullptr) ordering[id][0] = (*preCount)++;
+    // Three tiles of tile x tile cells must fit in half of the L2 cache (the other half is left to the rest of the data)
+    size_t cache = cacheSize(2);
+    if (cache == 0) cache = DEFAULT_L2_CACHE_SIZE;
+    uint32_t tile = static_cast<uint32_t>(std::sqrt(static_cast<double>(cache / 2 / (3 * cellSize(type)))));
 
-    // Visit all the unvisited neighbors
-    for (uint32_t i = 0; i < size; i++) {
-        if (data[id][i] != 0 && !visited[i]) {
-            dfs(i, ordering, visited, preCount, postCount);  // Recursive call
+    // Round it down to whole cache lines, so that each row of a tile starts on a cache line
+    const uint32_t cellsPerLine = CACHE_LINE_SIZE / cellSize(type);
+    return std::max(cellsPerLine, tile / cellsPerLine * cellsPerLine);
+}
+
+template<typename P, typename Relax>
+void Matrice::floydWarshallTile(P* paths, uint32_t stride, uint32_t kBegin, uint32_t kEnd,
+                                uint32_t iBegin, uint32_t iEnd, uint32_t jBegin, uint32_t jEnd, Relax&& relax)
+{
+    const P infinity = std::numeric_limits<P>::max();
+    for (uint32_t k = kBegin; k < kEnd; k++) {
+        const P* rowK = paths + static_cast<size_t>(k) * stride;
+        for (uint32_t i = iBegin; i < iEnd; i++) {
+            if (i == k) continue;  // Skip self-loops (so that the rows `i` and `k` never overlap)
+            P* rowI = paths + static_cast<size_t>(i) * stride;
+            P pathIK = rowI[k];
+            if (pathIK == infinity) continue;  // Skip "infinite" lengths
+            relax(i, k, rowI, rowK, pathIK, jBegin, jEnd);
         }
     }
-    
-    // Set the post-order only when all neighbors have been visited
-    if (postCount != nullptr) ordering[id][1] = (*postCount)++;
 }
 
-void Matrice::dfsCollect(uint32_t id, std::vector<uint32_t>* cluster, bool* visited,
-                         uint32_t* preCount, uint32_t* postCount) const
+template<typename Leaf>
+void Matrice::transposeBlocks(uint32_t iBegin, uint32_t iEnd, uint32_t jBegin, uint32_t jEnd, uint32_t leafSize, Leaf&& leaf)
 {
-    // Mark the node as visited
-    visited[id] = true;
-    // Add the node to the current cluster
-    cluster->push_back(id);
+    // Transpose small rectangles directly, and split the other ones in two along their longest side
+    uint32_t rows = iEnd - iBegin, columns = jEnd - jBegin;
+    if (rows <= leafSize && columns <= leafSize) {
+        if (rows != 0 && columns != 0) leaf(iBegin, iEnd, jBegin, jEnd);
+    } else if (rows >= columns) {
+        transposeBlocks(iBegin, iBegin + rows / 2, jBegin, jEnd, leafSize, leaf);
+        transposeBlocks(iBegin + rows / 2, iEnd, jBegin, jEnd, leafSize, leaf);
+    } else {
+        transposeBlocks(iBegin, iEnd, jBegin, jBegin + columns / 2, leafSize, leaf);
+        transposeBlocks(iBegin, iEnd, jBegin + columns / 2, jEnd, leafSize, leaf);
+    }
+}
 
-    // Visit all the unvisited neighbors
-    for (uint32_t i = 0; i < size; i++) {
-        if ((data[i][id] != 0) && !visited[i]) {
-            dfsCollect(i, cluster, visited, preCount, postCount);  // Recursive call
-        }
+void Matrice::transpose() const
+{
+    // Check if the computation has already been done (sparse matrices store their transposed rows from the start)
+    if (layout == Layout::Sparse || transposedData != nullptr) return;
+
+    if (layout == Layout::Bits) {
+        // Transpose the matrix block by block (64x64 bits at a time), the blocks being visited cache-obliviously
+        BitCells cells{static_cast<uint64_t*>(data), stride, size};
+        BitCells transposed{static_cast<uint64_t*>(allocateBits(size)), stride, size};
+        uint32_t blocks = (size + 63) / 64;
+        transposeBlocks(0, blocks, 0, blocks, 1, [&](uint32_t blockI, uint32_t, uint32_t blockJ, uint32_t) {
+            uint64_t block[64];
+            for (uint32_t k = 0; k < 64; k++) {
+                uint32_t i = blockI * 64 + k;
+                block[k] = i < size ? cells.row(i)[blockJ] : 0;
+            }
+            transposeBitBlock(block);
+            for (uint32_t k = 0; k < 64 && blockJ * 64 + k < size; k++) {
+                transposed.row(blockJ * 64 + k)[blockI] = block[k];
+            }
+        });
+        transposedData = transposed.data;
+        return;
     }
 
-    // Increment pre/post count. This is mainly useful to know when all nodes have been visited.
-    if (preCount != nullptr) (*preCount)++;
-    if (postCount != nullptr) (*postCount)++;
+    // Transpose the matrix cell by cell, by blocks small enough for both their rows and their columns to stay in the cache
+    dispatchCellType(type, [&](auto tag) {
+        using T = decltype(tag);
+        const T* cells = static_cast<const T*>(data);
+        T* transposed = static_cast<T*>(allocate(size, type));
+        transposeBlocks(0, size, 0, size, TRANSPOSE_LEAF_SIZE, [&](uint32_t iBegin, uint32_t iEnd, uint32_t jBegin, uint32_t jEnd) {
+            for (uint32_t i = iBegin; i < iEnd; i++) {
+                for (uint32_t j = jBegin; j < jEnd; j++) {
+                    transposed[static_cast<size_t>(j) * stride + i] = cells[static_cast<size_t>(i) * stride + j];
+                }
+            }
+        });
+        transposedData = transposed;
+    });
 }
@@ -1,11 +1,32 @@
 #ifndef MATRICE_H
 #define MATRICE_H
 
+#include "celltype.h"
+#include "hardware.h"
+#include "progress.h"
+
 #include <cstdint>
 #include <cstring>
 #include <string>
 #include <vector>
 
+#define CACHE_LINE_SIZE 64  // Alignment (in bytes) of each row of the matrix
+#define SPARSE_RATIO 64  // A matrix is stored sparse when less than 1 cell in SPARSE_RATIO is non-zero
+#define TRANSPOSE_LEAF_SIZE 32  // Side (in cells) of the blocks of a dense matrix transposed directly, the larger ones being split
+#define JOHNSON_NODE_COST 512  // Cost of settling a node in Dijkstra's algorithm, relative to relaxing a cell in Floyd-Warshall
+#define JOHNSON_EDGE_COST 256  // Cost of relaxing an edge in Dijkstra's algorithm, relative to relaxing a cell in Floyd-Warshall
+#define PRIM_CELL_COST 2  // Cost of a cell in Prim's algorithm with an array (distance and row, read in order by the kernels), relative to reading a cell in order
+#define PRIM_COLUMN_COST 3  // Additional cost of a cell when the column of each node is read too (oriented or not dense graphs, a row of the transposed copy), relative to reading a cell in order
+#define PRIM_HEAP_EDGE_COST 3  // Cost of an edge in Prim's algorithm with a heap, per level of the heap, relative to reading a cell in order
+#define KRUSKAL_EDGE_COST 6  // Cost of an edge in Kruskal's algorithm, per level of the sort, relative to reading a cell in order
+#define BORUVKA_EDGE_COST 8  // Cost of an edge in a round of Borůvka's algorithm, on a single thread, relative to reading a cell in order
+#define BORUVKA_CHUNK_SIZE 4096  // Number of edges (or nodes) handed to a thread at once in Borůvka's algorithm
+#define FORWARD_BACKWARD_COST 4  // Cost of the forward-backward algorithm on a single thread, relative to Tarjan's algorithm
+#define FORWARD_BACKWARD_CHUNK_SIZE 16384  // Number of cells (or edges) read by a thread at once in the forward-backward algorithm
+#define CLUSTER_NAME_NODES 16  // Maximum number of nodes listed in the name of a cluster (the other ones are only counted)
+
+class MappedFile;
+
 /**
  * @brief A class representing a square matrix and providing graph algorithms.
  */
@@ -13,6 +34,78 @@ class Matrice
 {
     
 public:
+    /**
+     * @brief How the cells of the matrix are stored in memory.
+     */
+    enum class Layout : uint8_t {
+        Dense,   // One cell of `CellType` per pair of nodes
+        Bits,    // One bit per pair of nodes (only for unweighted graphs, where every value is 0 or 1)
+        Sparse,  // Compressed sparse rows, plus their transpose (only the non-zero cells are stored)
+    };
+
+    /**
+     * @brief The algorithms computing the shortest paths between all pairs of nodes (see `shortestPaths`).
+     */
+    enum class ShortestPathsEngine : uint8_t {
+        FloydWarshall,  // O(n^3), vectorized: best for dense graphs
+        Johnson,        // O(n * m * log(n)), one Dijkstra per node: best for sparse graphs
+    };
+
+    /**
+     * @brief The algorithms computing the minimum spanning forest (see `minimumSpanningTree`).
+     */
+    enum class SpanningTreeEngine : uint8_t {
+        Prim,      // O(n^2), with an array of distances: best for dense graphs
+        HeapPrim,  // O(m * log(n)), with a heap of distances: best for sparse graphs
+        Kruskal,   // O(m * log(m)), sorting the edges: best for very sparse graphs
+        Boruvka,   // O(m * log(n)), in parallel: best for large sparse graphs on many threads
+    };
+
+    /**
+     * @brief The algorithms computing the strongly connected components (see `stronglyConnectedComponents`).
+     */
+    enum class SccEngine : uint8_t {
+        Tarjan,           // O(n + m), a single depth-first search: best on a few threads
+        ForwardBackward,  // O(m * log(n)) expected, in parallel: best for large graphs on many threads
+    };
+
+    /**
+     * @brief Get the name of a shortest paths engine (ex. "Floyd-Warshall").
+     * @param engine The engine.
+     * @return The name of the engine.
+     */
+    static const char* shortestPathsEngineName(ShortestPathsEngine engine);
+
+    /**
+     * @brief Get the name of a spanning tree engine (ex. "Kruskal").
+     * @param engine The engine.
+     * @return The name of the engine.
+     */
+    static const char* spanningTreeEngineName(SpanningTreeEngine engine);
+
+    /**
+     * @brief Get the name of a strongly connected components engine (ex. "Tarjan").
+     * @param engine The engine.
+     * @return The name of the engine.
+     */
+    static const char* sccEngineName(SccEngine engine);
+
+    /**
+     * @brief The shortest paths from a single source node (see `shortestPathsFrom`).
+     */
+    struct SingleSourcePaths {
+        /**
+         * @brief The length of the shortest path from the source to each node (0 for the source, INT64_MAX if there is no path).
+         */
+        std::vector<int64_t> distances;
+
+        /**
+         * @brief The node preceding each node on its shortest path from the source (UINT32_MAX for the source and unreachable nodes).
+         * The parents form the shortest paths tree, rooted at the source.
+         */
+        std::vector<uint32_t> parents;
+    };
+
     /******************************
     | Constructors and Destructor |
     ******************************/
@@ -29,8 +122,11 @@ public:
      * @brief Construct a new Matrice object by reading from a file.
      * The file should contain the size of the matrix on the first line,
      * followed by the matrix data, with each row on a new line, and each value separated by spaces.
+     * The file is mapped in memory and its rows are parsed in parallel (see `MatriceParser`).
+     * Binary files (written by `save`) are also accepted: their cells are used in place, without parsing nor copying.
      * @param path The path to the file containing the matrix data.
-     * @throws std::runtime_error if the file cannot be opened.
+     * @throws std::runtime_error if the file cannot be opened, or if it is an invalid binary file.
+     * @throws ParseError if the text file is malformed (with the line and column of the error).
      */
     Matrice(const std::string& path);
 
@@ -56,6 +152,18 @@ public:
      */
     friend std::ostream& operator<<(std::ostream& os, const Matrice& m);
 
+    /*********
+    | Export |
+    *********/
+
+    /**
+     * @brief Save the matrix in the binary format (see `BinaryHeader`), with its layout, cell type, flags and names.
+     * The file can be opened back with `Matrice(path)` in a few milliseconds, whatever its size.
+     * @param path The path to the file to write.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
     /**********************
     | Getters and Setters |
     **********************/
@@ -70,7 +178,7 @@ public:
      * @brief Get the value at the specified edge (row and column) in the matrix.
      * @param from The row index.
      * @param to The column index.
-     * @return The value at the specified position in the matrix.
+     * @return The value at the specified position in the matrix (INT64_MAX for infinity, whatever the cell type).
      */
     int64_t getEdge(uint32_t from, uint32_t to) const;
 
@@ -82,6 +190,21 @@ public:
      */
     std::string getName(uint32_t index) const;
 
+    /**
+     * @brief Get the type used to store each cell of the matrix.
+     * It is the narrowest type able to store every value of the matrix (see `fittingCellType`).
+     * @return The cell type.
+     */
+    CellType getCellType() const;
+
+    /**
+     * @brief Get how the cells of the matrix are stored in memory.
+     * Matrices with less than 1 non-zero cell in SPARSE_RATIO are stored sparse, the others are stored
+     * as bits if their values are all 0 or 1, and densely otherwise.
+     * @return The layout of the matrix.
+     */
+    Layout getLayout() const;
+
     /**
      * @brief Check if the graph represented by the matrix is oriented (directed).
      * A graph is considered oriented if there exists at least one pair (i, j) such that edge[i][j] != edge[j][i].
@@ -98,75 +221,534 @@ public:
      */
     bool isWeighted() const;
 
+    /**
+     * @brief Get the sum of the weights of the edges (the infinite ones being skipped).
+     * The edges of an undirected graph are stored in both directions, so they are counted twice (ex. for the result of `prim`).
+     * @return The total weight.
+     */
+    int64_t getTotalWeight() const;
+
     /*************
     | Algorithms |
     *************/
 
     /**
      * @brief Apply the Floyd-Warshall algorithm to find the shortest paths in the graph represented by the matrix.
+     * The distances are stored in the narrowest cell type able to hold any path length (at most `size - 1` edges).
+     * The matrix is processed by square tiles small enough to stay in the cache (see `floydWarshallTile`),
+     * which gives the same distances as the row by row algorithm, while reading the whole matrix `size / tileSize` times instead of `size` times.
+     * Independent tiles are computed in parallel, and the result is the same whatever the number of threads.
+     * @param tileSize The number of rows and columns of each tile (0 to choose it from the size of the L2 cache, see `floydWarshallTileSize`).
+     * @param threads The number of threads to use (0 to use the shared thread pool, with every hardware thread).
+     * @param nextHops If not nullptr, receives a new Matrice of next hops: the cell (i, j) is the node following `i` on a shortest path
+     * from `i` to `j` (INT64_MAX if there is no path), stored in the narrowest type able to hold a node index. See `route`.
+     * @param hooks If not nullptr, the progress callback (called with the intermediate nodes done, after each block of them, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return A 2D array representing the shortest path distances between each pair of vertices.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* floydWarshall(uint32_t tileSize = 0, uint32_t threads = 0, Matrice** nextHops = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Get the nodes of a shortest path, by following the next hops (this matrix must be a next-hop matrix, see `floydWarshall`).
+     * Its complexity is linear in the number of nodes of the path.
+     * @param from The first node of the path.
+     * @param to The last node of the path (if it is `from`, the path is the shortest cycle through it).
+     * @return The nodes of the path, from `from` to `to` (both included), or an empty vector if there is no path.
+     * @throws std::runtime_error if the path goes through a negative cycle (it has no shortest path).
+     */
+    std::vector<uint32_t> route(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Apply Johnson's algorithm to find the shortest paths in the graph represented by the matrix.
+     * The weights are first made non-negative without changing the shortest paths (with potentials computed by Bellman-Ford,
+     * only if some weights are negative), then Dijkstra's algorithm is run from each node, in parallel.
+     * The result is the same as the one of `floydWarshall` (including the cell type, and the shortest cycles on the diagonal).
+     * @param threads The number of threads to use (0 to use the shared thread pool, with every hardware thread).
+     * @param nextHops If not nullptr, receives a new Matrice of next hops (see `floydWarshall`).
+     * @param hooks If not nullptr, the progress callback (called with the source nodes done, after each batch of them, out of `size`) and the cancellation token, see `ProgressHooks`.
      * @return A 2D array representing the shortest path distances between each pair of vertices.
+     * @throws std::runtime_error if the graph contains a negative cycle.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
      */
-    Matrice* floydWarshall() const;
+    Matrice* johnson(uint32_t threads = 0, Matrice** nextHops = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Choose the fastest shortest paths engine for the graph, from its density and the sign of its weights.
+     * Floyd-Warshall relaxes n^3 cells, while each of the n runs of Dijkstra settles up to n nodes and relaxes up to m edges,
+     * each of them far slower than a (vectorized) cell (see JOHNSON_NODE_COST and JOHNSON_EDGE_COST): Johnson's algorithm
+     * is only chosen when it is estimated faster, i.e. for large sparse graphs. Negative weights double the cost of the edges,
+     * for the Bellman-Ford passes needed first.
+     * @return The chosen engine.
+     */
+    ShortestPathsEngine shortestPathsEngine() const;
+
+    /**
+     * @brief Find the shortest paths between all pairs of nodes, with the engine chosen by `shortestPathsEngine`.
+     * If Johnson's algorithm finds a negative cycle, Floyd-Warshall is used instead (its result is then undefined, but it does not fail).
+     * @param nextHops If not nullptr, receives a new Matrice of next hops (see `floydWarshall`).
+     * @param engine If not nullptr, receives the engine actually used.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the engine, see `ProgressHooks`.
+     * @return A 2D array representing the shortest path distances between each pair of vertices.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* shortestPaths(Matrice** nextHops = nullptr, ShortestPathsEngine* engine = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Apply Dijkstra's algorithm to find the shortest paths from a single node, with a radix heap (see `RadixHeap`).
+     * Only the nodes reachable from the source are visited, each edge being relaxed once: O(m + n * log(C)), where C is the largest weight.
+     * @param source The index of the source node.
+     * @param hooks If not nullptr, the progress callback (called with the nodes settled, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return The distances from the source and the shortest paths tree.
+     * @throws std::runtime_error if a negative weight is reachable from the source (use `bellmanFord` instead).
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    SingleSourcePaths dijkstra(uint32_t source, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Apply the Bellman-Ford algorithm to find the shortest paths from a single node, allowing negative weights.
+     * Only the nodes whose distance changed are relaxed again (queue-based variant, also known as SPFA), which is O(n * m) at worst,
+     * but usually close to linear.
+     * @param source The index of the source node.
+     * @param hooks If not nullptr, the progress callback (called with the nodes reached so far, out of `size`) and the cancellation token,
+     * checked at each node taken from the queue, see `ProgressHooks`.
+     * @return The distances from the source and the shortest paths tree.
+     * @throws std::runtime_error if a negative cycle is reachable from the source (its nodes are given in the message, when found).
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    SingleSourcePaths bellmanFord(uint32_t source, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Find the shortest paths from a single node, without computing the ones of the other nodes (see `shortestPaths`):
+     * with Dijkstra's algorithm, or the Bellman-Ford algorithm if a negative weight is reachable from the source.
+     * The distance of the source is 0, while the diagonal of `shortestPaths` holds the shortest cycle through each node.
+     * @param source The index of the source node.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the algorithm, see `ProgressHooks`.
+     * @return The distances from the source and the shortest paths tree.
+     * @throws std::runtime_error if a negative cycle is reachable from the source.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    SingleSourcePaths shortestPathsFrom(uint32_t source, const ProgressHooks* hooks = nullptr) const;
 
     /**
      * @brief Apply Prim's algorithm to find the Minimum Spanning Tree (MST) of the graph represented by the matrix.
-     * @return A new Matrice representing the MST.
+     * The graph is interpreted as undirected: nodes are linked if there is an edge in either direction (with the smallest of both weights).
+     * If it is not connected, the result is a minimum spanning forest, with a tree for each connected component.
+     * The next node is found by scanning an array of distances, in O(n^2) in total.
+     * Dense matrices are processed by vectorized kernels (see `densePrim`), the other layouts by visiting the edges of each node.
+     * @param level The SIMD instruction set of the kernels (it must be supported by the processor). Defaults to the newest supported one.
+     * @param hooks If not nullptr, the progress callback (called with the nodes added to the tree, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return A new Matrice representing the MST (each edge in both directions).
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* prim(SimdLevel level = simdLevel(), const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Same as `prim`, but the next node is found with a 4-ary heap of distances (see `DaryHeap`), in O(m * log(n)) in total.
+     * @param hooks If not nullptr, the progress callback (called with the nodes added to the tree, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return A new Matrice representing the MST (each edge in both directions), with the same total weight as `prim`.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* heapPrim(const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Apply Kruskal's algorithm to find the Minimum Spanning Tree (MST) of the graph represented by the matrix:
+     * the edges are added by increasing weight, unless they link nodes already connected (found with a union-find, see `UnionFind`).
+     * Same interpretation of the graph as `prim`.
+     * @param hooks If not nullptr, the progress callback (called with the rows gathered, then `size` plus the nodes connected, out of `2 * size`) and the cancellation token, see `ProgressHooks`.
+     * @return A new Matrice representing the MST (each edge in both directions), with the same total weight as `prim`.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* kruskal(const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Apply Borůvka's algorithm to find the Minimum Spanning Tree (MST) of the graph represented by the matrix, in parallel.
+     * Each round finds the cheapest edge leaving every component (ties broken by the order of the edges, so that they never form a cycle),
+     * each block of edges on a thread, then merges the components along these edges with a lock-free union-find (see `ConcurrentUnionFind`),
+     * and drops the edges now inside a component. The number of components is at least halved by each round, so there are at most log2(n) rounds.
+     * Same interpretation of the graph as `prim`, and the result does not depend on the number of threads.
+     * @param threads The number of threads to use (0 to use the shared thread pool, with every hardware thread).
+     * @param hooks If not nullptr, the progress callback (called with the nodes connected, after each round, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return A new Matrice representing the MST (each edge in both directions), with the same total weight as `prim`.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
      */
-    Matrice* prim() const;
+    Matrice* boruvka(uint32_t threads = 0, const ProgressHooks* hooks = nullptr) const;
 
     /**
-     * @brief Compute the clusters in the graph represented by the matrix, using the Kosaraju algorithm.
-     * @return A vector of clusters, where each cluster is represented by a vector of node indexes.
+     * @brief Choose the fastest spanning tree engine for the graph, from its density and its layout.
+     * Prim's algorithm with an array scans n^2 cells (see PRIM_CELL_COST), and their columns unless the matrix is dense and not oriented
+     * (see PRIM_COLUMN_COST), while the heap costs a logarithmic time per edge (see PRIM_HEAP_EDGE_COST), and Kruskal's algorithm
+     * sorts the edges (see KRUSKAL_EDGE_COST). Unless the matrix is sparse, finding the edges of a node means reading its whole row
+     * and column: the heap is then never faster than the array,
+     * but Kruskal's algorithm, reading every cell only once and in order, is faster for graphs with few edges.
+     * Borůvka's algorithm costs a few operations per edge and per round (see BORUVKA_EDGE_COST), shared by the threads of the pool.
+     * @return The chosen engine.
      */
-    std::vector<std::vector<uint32_t>> kosaraju() const;
+    SpanningTreeEngine spanningTreeEngine() const;
 
     /**
-     * @brief Create a new Matrice representing the clusters of the current Matrice.
-     * Each cluster is represented as a single node, with edges between clusters representing edges between any nodes in these clusters.
+     * @brief Find the minimum spanning forest of the graph, with the engine chosen by `spanningTreeEngine`.
+     * @param engine If not nullptr, receives the engine used.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the engine, see `ProgressHooks`.
+     * @return A new Matrice representing the MST (each edge in both directions).
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* minimumSpanningTree(SpanningTreeEngine* engine = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Compute the clusters (strongly connected components) in the graph represented by the matrix, using Tarjan's algorithm
+     * in Pearce's variant: a single depth-first search, with an explicit stack (so that long paths cannot overflow the call stack)
+     * and flat arrays allocated once. Its complexity is the one of walking every row once: O(n + m) for sparse matrices, O(n^2) otherwise.
+     * @param hooks If not nullptr, the progress callback (called with the nodes visited, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return A vector of clusters, where each cluster is represented by a vector of node indexes (in increasing order).
+     * The clusters are in topological order: no edge goes from a cluster to a previous one.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    std::vector<std::vector<uint32_t>> tarjan(const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Compute the clusters (strongly connected components) in the graph, in parallel, with the forward-backward algorithm:
+     * the nodes reached both forward and backward from a pivot form its cluster, and the nodes reached only forward, only backward
+     * or not at all form three subgraphs, split again at the next round. These rounds alternate with coloring rounds, which split off
+     * many small clusters at once: each node takes the color of the largest node reaching it, and the nodes of a color reaching it form its cluster.
+     * Before each round, the nodes without any predecessor or successor in their subgraph are trimmed (they are clusters on their own).
+     * Each step reads the rows of the nodes left by blocks (see FORWARD_BACKWARD_CHUNK_SIZE), on every thread, and the pivots are chosen
+     * by a fixed hash of the nodes, so that the result does not depend on the number of threads.
+     * @param threads The number of threads to use (0 to use the shared thread pool, with every hardware thread).
+     * @param hooks If not nullptr, the progress callback (called with the nodes whose cluster is found, after each round, out of `size`) and the cancellation token, see `ProgressHooks`.
+     * @return The same clusters as `tarjan` (each in increasing order), in a topological order too, which may differ from the one of `tarjan`
+     * between clusters not linked by any path.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    std::vector<std::vector<uint32_t>> forwardBackward(uint32_t threads = 0, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Choose the fastest strongly connected components engine for the graph, from its size and the threads of the pool.
+     * Both engines read every row about once per round, but the forward-backward algorithm costs more (see FORWARD_BACKWARD_COST),
+     * so it is only chosen when shared by enough threads.
+     * @return The chosen engine.
+     */
+    SccEngine sccEngine() const;
+
+    /**
+     * @brief Compute the clusters (strongly connected components) of the graph, with the engine chosen by `sccEngine`.
+     * @param engine If not nullptr, receives the engine used.
+     * @param hooks If not nullptr, the progress callback and the cancellation token of the engine, see `ProgressHooks`.
+     * @return A vector of clusters (each in increasing order), in topological order.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    std::vector<std::vector<uint32_t>> stronglyConnectedComponents(SccEngine* engine = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Create a new Matrice representing the clusters of the current Matrice (found by `stronglyConnectedComponents`).
+     * Each cluster is represented as a single node, with edges between clusters representing edges between any nodes in these clusters
+     * (weighted by the number of these edges). The edges are counted in a single pass over the edges of the graph, so that it costs O(n + m)
+     * on top of finding the clusters, and the result is stored with the most compact layout: sparse if there are few edges between clusters.
+     * Cluster names list their first nodes (see CLUSTER_NAME_NODES), followed by the number of other ones (ex. "{a,b,… +12}").
+     * @param engine If not nullptr, receives the engine used to find the clusters.
+     * @param hooks If not nullptr, the progress callback (called with the nodes whose cluster is found, then `size` plus the nodes whose edges are counted, out of `2 * size`) and the cancellation token, see `ProgressHooks`.
+     * @return A new Matrice representing the clusters.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
+     */
+    Matrice* clusterMatrice(SccEngine* engine = nullptr, const ProgressHooks* hooks = nullptr) const;
+
+    /**
+     * @brief Same as `clusterMatrice`, but with clusters already found (ex. kept from a previous call to `stronglyConnectedComponents`).
+     * @param clusters The clusters of the graph: every node in exactly one of them, in topological order.
+     * @param hooks If not nullptr, the progress callback (called with the nodes whose edges are counted, out of `size`) and the cancellation token, see `ProgressHooks`.
      * @return A new Matrice representing the clusters.
+     * @throws CancelledError if the cancellation token of the hooks is raised.
      */
-    Matrice* clusterMatrice() const;
+    Matrice* clusterMatrice(const std::vector<std::vector<uint32_t>>& clusters, const ProgressHooks* hooks = nullptr) const;
 
 private:
     /***********************
     | Private Constructors |
     ***********************/
 
+    /**
+     * @brief An edge of the graph, used to build matrices from their edges.
+     */
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+        int64_t weight;
+    };
+
+    /**
+     * @brief Construct a new Matrice object from its edges, stored with the most compact layout and cell type.
+     * @param size The size of the matrix (size x size).
+     * @param edges The edges of the graph, in any order (they are sorted in place, and only the last of duplicates is kept).
+     * @param names An optional array of strings representing the names of the nodes. If nullptr, nodes are unnamed and represented by their indexes+1.
+     */
+    Matrice(uint32_t size, std::vector<Edge>& edges, std::string* names = nullptr);
+
     /**
      * @brief Construct a new Matrice object with given size and data.
      * @param size The size of the matrix (size x size).
-     * @param data A 2D array of int64_t representing the matrix data.
+     * @param layout How the data is stored.
+     * @param type The type of each cell of the data (ignored for the Bits layout).
+     * @param data A contiguous buffer representing the matrix data, allocated with `allocate(size, type)` or `allocateBits(size)` (ownership is taken).
      * @param names An optional array of strings representing the names of the nodes. If nullptr, nodes are unnamed and represented by their indexes+1.
      */
-    Matrice(uint32_t size, int64_t** data, std::string* names = nullptr);
+    Matrice(uint32_t size, Layout layout, CellType type, void* data, std::string* names = nullptr);
+
+    /**
+     * @brief Store the given values with the most compact layout and cell type (sets `layout`, `type`, `stride` and `data` or `sparse`).
+     * @param rows A function returning a pointer to the int32_t values of the given row.
+     * @param min The smallest value.
+     * @param max The largest value.
+     * @param nonZero The number of non-zero values.
+     */
+    template<typename Rows>
+    void storeCompact(Rows&& rows, int32_t min, int32_t max, uint64_t nonZero);
+
+    /**
+     * @brief Store the given edges with the Sparse layout (sets `layout`, `type`, `sparse` and `reverse`).
+     * @param edges The edges, sorted by source then destination, without duplicates nor zero weights.
+     * @param type The type able to store every weight.
+     */
+    void storeSparse(const std::vector<Edge>& edges, CellType type);
+
+    /**
+     * @brief Parse a text file (sets `size` and stores the cells with `storeCompact`).
+     * @param file The mapped file.
+     * @throws ParseError if the file is malformed.
+     */
+    void parseText(const MappedFile& file);
+
+    /**
+     * @brief Use the cells of a binary file in place (sets every attribute but `mapping`, see `BinaryHeader`).
+     * @param file The mapped file, which must outlive the matrix.
+     * @throws std::runtime_error if the file is not a valid binary file.
+     */
+    void openBinary(const MappedFile& file);
+
+    /**
+     * @brief Get the size (in bytes) of each section of a binary file, in the order they are stored (see `BinaryHeader`).
+     * @param size The size of the matrix.
+     * @param layout The layout of the matrix.
+     * @param type The type of each cell.
+     * @param cells The number of stored cells (Sparse layout only).
+     * @return The size of each section.
+     */
+    static std::vector<size_t> binarySections(uint32_t size, Layout layout, CellType type, uint64_t cells);
+
+    /****************
+    | Graph Helpers |
+    ****************/
+
+    /**
+     * @brief The edges of the graph as compressed sparse rows, with 64-bit weights (see `adjacency`).
+     */
+    struct Adjacency {
+        /**
+         * @brief For each node `i`, its edges are at the indexes [offsets[i], offsets[i + 1]) of `targets` and `weights` (size + 1 entries).
+         */
+        std::vector<uint64_t> offsets;
+
+        /**
+         * @brief The destination of each edge.
+         */
+        std::vector<uint32_t> targets;
+
+        /**
+         * @brief The weight of each edge.
+         */
+        std::vector<int64_t> weights;
+    };
+
+    /**
+     * @brief Get the edges of the graph (the non-zero, non-infinite cells), whatever the layout of the matrix.
+     * @return The edges, grouped by source, in increasing order of destination.
+     */
+    Adjacency adjacency() const;
+
+    /**
+     * @brief Find the range of the weights of the graph, and count its edges.
+     * @param minWeight Receives the smallest weight (0 if there is no negative weight).
+     * @param maxWeight Receives the largest weight (0 if there is no positive weight).
+     * @param edges If not nullptr, receives the number of edges (non-zero cells).
+     */
+    void weightRange(int64_t* minWeight, int64_t* maxWeight, uint64_t* edges = nullptr) const;
+
+    /**
+     * @brief Get the narrowest cell type able to store the sum of two shortest paths (each having at most size-1 edges) and the cycles of the diagonal (at most size edges), without overflows.
+     * @param minWeight The smallest weight of the graph (0 or less).
+     * @param maxWeight The largest weight of the graph (0 or more).
+     * @return The cell type of the shortest paths matrix.
+     */
+    CellType shortestPathsType(int64_t minWeight, int64_t maxWeight) const;
+
+    /*****************
+    | Memory Helpers |
+    *****************/
+
+    /**
+     * @brief Allocate a zero-initialized, cache-line-aligned buffer.
+     * The buffer must be freed with `deallocate`.
+     * @param bytes The size of the buffer (in bytes).
+     * @return The allocated buffer.
+     */
+    static void* allocateBytes(size_t bytes);
+
+    /**
+     * @brief Compute the stride (number of cells between the start of two consecutive rows) for a matrix of the given size.
+     * The stride is rounded up so that every row starts on a cache line.
+     * @param size The size of the matrix.
+     * @param type The type of each cell.
+     * @return The stride of the matrix.
+     */
+    static uint32_t computeStride(uint32_t size, CellType type);
+
+    /**
+     * @brief Allocate a zero-initialized, cache-line-aligned buffer for a matrix of the given size.
+     * The buffer must be freed with `deallocate`.
+     * @param size The size of the matrix.
+     * @param type The type of each cell.
+     * @return The allocated buffer, with `size` rows of `computeStride(size, type)` cells.
+     */
+    static void* allocate(uint32_t size, CellType type);
+
+    /**
+     * @brief Compute the stride (number of 64-bit words between the start of two consecutive rows) for a bit matrix of the given size.
+     * @param size The size of the matrix.
+     * @return The stride of the matrix.
+     */
+    static uint32_t computeBitStride(uint32_t size);
+
+    /**
+     * @brief Allocate a zero-initialized, cache-line-aligned buffer for a bit matrix of the given size.
+     * The buffer must be freed with `deallocate`.
+     * @param size The size of the matrix.
+     * @return The allocated buffer, with `size` rows of `computeBitStride(size)` words.
+     */
+    static void* allocateBits(uint32_t size);
+
+    /**
+     * @brief Free a buffer allocated with `allocate`, `allocateBits` or `allocateBytes`.
+     * @param buffer The buffer to free (nullptr is ignored).
+     */
+    static void deallocate(void* buffer);
+
+    /**
+     * @brief Call a (generic) function with an accessor to the cells of the matrix (`DenseCells<T>`, `BitCells` or `SparseCells<T>`).
+     * This is used to instantiate the algorithms for each layout and cell type, with a single switch per call.
+     * @param function The function to call, taking the accessor as argument.
+     * @return The value returned by the function.
+     */
+    template<typename Function>
+    auto visitCells(Function&& function) const;
+
+    /**
+     * @brief Same as `visitCells`, but with an accessor to the transposed matrix (its row `i` is the column `i` of this matrix).
+     * Sparse matrices use their transposed rows, dense and bit matrices a transposed copy (computed on first use, see `transpose`),
+     * so that the predecessors of a node are always read in order.
+     * @param function The function to call, taking the accessor as argument.
+     * @return The value returned by the function.
+     */
+    template<typename Function>
+    auto visitReverseCells(Function&& function) const;
+
+    /**
+     * @brief Same as `visitCells`, but with two accessors of the same type: to the matrix, and to the transposed matrix (see `visitReverseCells`).
+     * @param function The function to call, taking both accessors as arguments.
+     * @return The value returned by the function.
+     */
+    template<typename Function>
+    auto visitCellsAndTranspose(Function&& function) const;
+
+    /**
+     * @brief Compute the transposed matrix (Dense and Bits layouts only) in `transposedData`, if not done yet.
+     * It has the same layout, cell type and stride as the matrix, and is built with a cache-oblivious transposition (see `transposeBlocks`).
+     * The matrix is never modified once built, so the copy stays valid as long as the matrix.
+     */
+    void transpose() const;
 
     /*****************
     | Sub-Algorithms |
     *****************/
 
     /**
-     * @brief Helper function for depth-first search to find connected components.
-     * This function automatically updates given variables.
-     * @param id The current node index.
-     * @param ordering The 2D array to store pre and post order numbers. For each node, pre-order is at index 0, post-order at index 1.
-     * @param visited An array to keep track of visited nodes.
-     * @param preCount A pointer to the count of nodes visited before the current node.
-     * @param postCount A pointer to the count of nodes visited after the current node.
+     * @brief Get the default tile size of `floydWarshall`: the largest one such that three tiles (the updated one, and the tiles
+     * holding its paths to and from the intermediate nodes) fill at most half of the L2 cache, in whole cache lines.
+     * @param type The type of each cell of the paths matrix.
+     * @return The tile size.
+     */
+    static uint32_t floydWarshallTileSize(CellType type);
+
+    /**
+     * @brief Prim's algorithm on a dense matrix with cells of type `T` (see `prim`).
+     * Each node added to the tree relaxes the distances with its row, read in order by a branchless kernel (see `primRelaxKernel`),
+     * and the next node is found by a vectorized scan of the distances (see `primArgminKernel`). The column of the node
+     * (the edges towards it, read with a stride) is only needed if the graph is oriented: otherwise it is the same as the row.
+     * @param level The SIMD instruction set of the kernels.
+     * @param progress The progress policy (see `runWithProgress`).
+     * @return A new Matrice representing the MST (each edge in both directions).
+     */
+    template<typename T, typename Progress>
+    Matrice* densePrim(SimdLevel level, Progress& progress) const;
+
+    /**
+     * @brief The algorithms accepting hooks, run with a progress policy (see `runWithProgress`): `NoProgress` if they have no hooks,
+     * so that their loops are compiled without any check, `HookedProgress` otherwise. See their public versions.
+     */
+    template<typename Progress>
+    Matrice* floydWarshall(uint32_t tileSize, uint32_t threads, Matrice** nextHops, Progress& progress) const;
+    template<typename Progress>
+    Matrice* johnson(uint32_t threads, Matrice** nextHops, Progress& progress) const;
+    template<typename Progress>
+    SingleSourcePaths dijkstra(uint32_t source, Progress& progress) const;
+    template<typename Progress>
+    SingleSourcePaths bellmanFord(uint32_t source, Progress& progress) const;
+    template<typename Progress>
+    Matrice* prim(SimdLevel level, Progress& progress) const;
+    template<typename Progress>
+    Matrice* heapPrim(Progress& progress) const;
+    template<typename Progress>
+    Matrice* kruskal(Progress& progress) const;
+    template<typename Progress>
+    Matrice* boruvka(uint32_t threads, Progress& progress) const;
+    template<typename Progress>
+    std::vector<std::vector<uint32_t>> tarjan(Progress& progress) const;
+    template<typename Progress>
+    std::vector<std::vector<uint32_t>> forwardBackward(uint32_t threads, Progress& progress) const;
+    template<typename Progress>
+    std::vector<std::vector<uint32_t>> stronglyConnectedComponents(SccEngine* engine, Progress& progress) const;
+    template<typename Progress>
+    Matrice* clusterMatrice(const std::vector<std::vector<uint32_t>>& clusters, Progress& progress) const;
+
+    /**
+     * @brief Relax the paths of a tile of the Floyd-Warshall algorithm through some intermediate nodes.
+     * For each intermediate node `k` (in order), each path `i -> j` of the tile is replaced by `i -> k -> j` if it is shorter.
+     * Infinite lengths (maximum of `P`) are never used as intermediate paths.
+     * @param paths The paths matrix.
+     * @param stride The stride of the paths matrix.
+     * @param kBegin The first intermediate node.
+     * @param kEnd The node after the last intermediate node.
+     * @param iBegin The first row of the tile.
+     * @param iEnd The row after the last row of the tile.
+     * @param jBegin The first column of the tile (at the start of a cache line).
+     * @param jEnd The column after the last column of the tile (at the start of a cache line, or the end of the padded row).
+     * @param relax The function relaxing the columns [jBegin, jEnd) of a row through `k` (usually with a `minPlusKernel`),
+     * taking `i`, `k`, the rows `i` and `k`, the length of `i -> k` (not infinite), `jBegin` and `jEnd`.
      */
-    void dfs(uint32_t id, uint32_t** ordering, bool* visited,
-             uint32_t* preCount = nullptr, uint32_t* postCount = nullptr) const;
+    template<typename P, typename Relax>
+    static void floydWarshallTile(P* paths, uint32_t stride, uint32_t kBegin, uint32_t kEnd,
+                                  uint32_t iBegin, uint32_t iEnd, uint32_t jBegin, uint32_t jEnd, Relax&& relax);
 
     /**
-     * @brief Helper function for depth-first search to collect nodes in a cluster.
-     * @param id The current node index.
-     * @param cluster The vector representing the current cluster.
-     * @param visited An array to keep track of visited nodes.
-     * @param preCount A pointer to the count of nodes visited before the current node.
-     * @param postCount A pointer to the count of nodes visited after the current node.
+     * @brief Transpose a rectangle of blocks, cache-obliviously: its longest side is halved until it is at most `leafSize` blocks long,
+     * so that the rows read and the rows written eventually fit in the cache, whatever its size.
+     * @param iBegin The first row of blocks.
+     * @param iEnd The row after the last row of blocks.
+     * @param jBegin The first column of blocks.
+     * @param jEnd The column after the last column of blocks.
+     * @param leafSize The side (in blocks) of the rectangles transposed directly.
+     * @param leaf The function transposing a small rectangle directly, taking `iBegin`, `iEnd`, `jBegin` and `jEnd`.
      */
-    void dfsCollect(uint32_t id, std::vector<uint32_t>* cluster, bool* visited,
-                    uint32_t* preCount = nullptr, uint32_t* postCount = nullptr) const;
-                    
+    template<typename Leaf>
+    static void transposeBlocks(uint32_t iBegin, uint32_t iEnd, uint32_t jBegin, uint32_t jEnd, uint32_t leafSize, Leaf&& leaf);
+
     /*************
     | Attributes |
     *************/
@@ -177,10 +759,49 @@ private:
     uint32_t size;
 
     /**
-     * @brief A 2D array of int64_t representing the matrix data.
-     * Using int64 allow to store an int32_t (the original data) and an uint32_t (the size of the matrix).
+     * @brief The number of cells (or 64-bit words, for the Bits layout) between the start of two consecutive rows (padded to a cache line).
+     */
+    uint32_t stride;
+
+    /**
+     * @brief How the cells are stored (dense cells of `type`, bits, or sparse rows).
+     */
+    Layout layout;
+
+    /**
+     * @brief The type of each cell of the matrix (the narrowest one fitting all its values).
+     */
+    CellType type;
+
+    /**
+     * @brief A contiguous, cache-line-aligned buffer representing the matrix data, stored row by row.
+     * Use `visitCells` to access it: with the Dense layout, cells are of the C++ type matching `type`, and
+     * the maximum value of that type represents infinity (see `getEdge`). With the Bits layout, each row is
+     * a sequence of 64-bit words. Unused (nullptr) with the Sparse layout.
+     */
+    void* data;
+
+    /**
+     * @brief The transposed matrix (Dense and Bits layouts only), used to read the predecessors of a node in order.
+     * It is computed on first use (see `transpose`), nullptr otherwise.
+     */
+    mutable void* transposedData = nullptr;
+
+    /**
+     * @brief The non-zero cells of each row (Sparse layout only).
+     */
+    SparseRows sparse;
+
+    /**
+     * @brief The non-zero cells of each column, i.e. the rows of the transposed matrix (Sparse layout only).
+     */
+    SparseRows reverse;
+
+    /**
+     * @brief The binary file the cells are stored in, when opened from one (nullptr otherwise).
+     * In this case, `data`, `sparse` and `reverse` point into the file, and are not freed.
      */
-    int64_t** data;
+    MappedFile* mapping = nullptr;
 
     /**
      * @brief An array of C-strings representing the names of the nodes.
@@ -0,0 +1,316 @@
+#include "matriceparser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <vector>
+
+/**********
+| Helpers |
+**********/
+
+namespace {
+
+/**
+ * @brief Check whether a character separates values (end of lines excluded).
+ */
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/**
+ * @brief Skip the blank characters at the given position, without going past the end of the line.
+ */
+inline const char* skipBlanks(const char* cursor, const char* lineEnd)
+{
+    while (cursor != lineEnd && isBlank(*cursor)) cursor++;
+    return cursor;
+}
+
+/**
+ * @brief Find the end of the line starting at the given position (its '\n', or the end of the text).
+ */
+inline const char* findLineEnd(const char* cursor, const char* end)
+{
+    if (cursor == end) return end;  // `memchr` must not be called on a null pointer (empty text)
+    const void* found = std::memchr(cursor, '\n', end - cursor);
+    return found ? static_cast<const char*>(found) : end;
+}
+
+/**
+ * @brief Parse a (signed) integer at the given position, with a hand-rolled scanner (faster than `std::from_chars`
+ * and locale-independent, as it only handles the decimal digits and the sign).
+ * @param cursor The first character of the integer.
+ * @param lineEnd The end of the line.
+ * @param value The parsed integer.
+ * @return The character after the integer, `cursor` if there is no integer, or nullptr if it does not fit in an int32_t.
+ */
+inline const char* parseValue(const char* cursor, const char* lineEnd, int32_t& value)
+{
+    bool negative = *cursor == '-';
+    const char* digits = cursor + (negative || *cursor == '+');
+    const char* position = digits;
+    uint64_t magnitude = 0;
+    while (position != lineEnd && static_cast<unsigned char>(*position - '0') < 10) {
+        magnitude = magnitude * 10 + (*position - '0');
+        if (magnitude > uint64_t(INT32_MAX) + negative) return nullptr;
+        position++;
+    }
+    if (position == digits) return cursor;
+    value = negative ? static_cast<int32_t>(-static_cast<int64_t>(magnitude)) : static_cast<int32_t>(magnitude);
+    return position;
+}
+
+/**
+ * @brief Describe a character for an error message (quoted if printable, as a byte value otherwise).
+ */
+std::string describe(char c)
+{
+    if (c >= ' ' && c <= '~') return std::string("'") + c + "'";
+    char hex[8];
+    std::snprintf(hex, sizeof(hex), "0x%02X", static_cast<unsigned char>(c));
+    return std::string("byte ") + hex;
+}
+
+/**
+ * @brief A range of whole lines of the text, parsed by a single thread.
+ */
+struct Chunk {
+    const char* begin;             // The first character of the chunk (start of a line)
+    const char* end;               // The character after the chunk (start of a line, or end of the text)
+    uint64_t line = 0;             // The line of the first character
+    uint64_t row = 0;              // The row of the first non-blank line
+    uint64_t lines = 0;            // The number of lines of the chunk
+    uint64_t rows = 0;             // The number of non-blank lines of the chunk
+    MatriceParser::Values values;  // Statistics about the parsed values
+    std::exception_ptr error;      // The first error of the chunk, if any
+};
+
+/**
+ * @brief Count the lines and the rows (non-blank lines) of a chunk.
+ */
+void countRows(Chunk& chunk)
+{
+    for (const char* cursor = chunk.begin; cursor < chunk.end; chunk.lines++) {
+        const char* lineEnd = findLineEnd(cursor, chunk.end);
+        chunk.rows += skipBlanks(cursor, lineEnd) != lineEnd;
+        cursor = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Parse the rows of a chunk, storing the values in the rows of the buffer starting at `chunk.row`.
+ * The lines and rows of the chunk are counted again while parsing.
+ */
+void parseChunk(Chunk& chunk, uint32_t size, int32_t* data, uint32_t stride)
+{
+    MatriceParser::Values& values = chunk.values;
+    uint64_t line = chunk.line;
+    uint64_t row = chunk.row;
+    for (const char* cursor = chunk.begin; cursor < chunk.end; cursor++, line++) {
+        const char* lineEnd = findLineEnd(cursor, chunk.end);
+        const char* position = skipBlanks(cursor, lineEnd);
+
+        // Ignore blank lines
+        if (position == lineEnd) {
+            cursor = lineEnd;
+            continue;
+        }
+        if (row >= size) {
+            throw ParseError(line, position - cursor + 1, "expected " + std::to_string(size) + " rows, found more");
+        }
+
+        // Parse each value of the row
+        int32_t* cells = data + static_cast<size_t>(row) * stride;
+        for (uint32_t j = 0; j < size; j++) {
+            position = skipBlanks(position, lineEnd);
+            if (position == lineEnd) {
+                throw ParseError(line, position - cursor + 1, "expected " + std::to_string(size) + " values, found " + std::to_string(j));
+            }
+            int32_t value;
+            const char* next = parseValue(position, lineEnd, value);
+            if (next == nullptr) {
+                throw ParseError(line, position - cursor + 1, "value out of range (values must fit in 32 bits)");
+            }
+            if (next == position) {
+                throw ParseError(line, position - cursor + 1, "expected an integer, found " + describe(*position));
+            }
+            if (next != lineEnd && !isBlank(*next)) {
+                throw ParseError(line, next - cursor + 1, "unexpected character " + describe(*next));
+            }
+            cells[j] = value;
+            values.min = std::min(values.min, value);
+            values.max = std::max(values.max, value);
+            values.nonZero += value != 0;
+            position = next;
+        }
+
+        // Check that the row has no extra values
+        position = skipBlanks(position, lineEnd);
+        if (position != lineEnd) {
+            throw ParseError(line, position - cursor + 1, "expected " + std::to_string(size) + " values, found more");
+        }
+        row++;
+        cursor = lineEnd;
+    }
+    chunk.lines = line - chunk.line;
+    chunk.rows = row - chunk.row;
+}
+
+/**
+ * @brief Call a function with the index of each chunk, each chunk (but the first one) in its own thread.
+ * Errors thrown by the function are stored in their chunk.
+ */
+template<typename Function>
+void forEachChunk(std::vector<Chunk>& chunks, Function&& function)
+{
+    auto run = [&](size_t index) {
+        try {
+            function(index);
+        } catch (...) {
+            chunks[index].error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t index = 1; index < chunks.size(); index++) {
+        workers.emplace_back(run, index);
+    }
+    run(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}
+
+/*************
+| ParseError |
+*************/
+
+ParseError::ParseError(uint64_t line, uint64_t column, const std::string& message):
+    std::runtime_error("Line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message),
+    line(line),
+    column(column)
+{
+}
+
+uint64_t ParseError::getLine() const
+{
+    return line;
+}
+
+uint64_t ParseError::getColumn() const
+{
+    return column;
+}
+
+/****************
+| MatriceParser |
+****************/
+
+MatriceParser::MatriceParser(const char* text, size_t length):
+    text(text),
+    length(length),
+    rowsOffset(0),
+    rowsLine(1)
+{
+}
+
+uint32_t MatriceParser::parseSize()
+{
+    // Skip the leading blank lines
+    const char* end = text + length;
+    const char* cursor = text;
+    uint64_t line = 1;
+    const char* lineEnd = findLineEnd(cursor, end);
+    const char* position = skipBlanks(cursor, lineEnd);
+    while (position == lineEnd && lineEnd != end) {
+        cursor = lineEnd + 1;
+        line++;
+        lineEnd = findLineEnd(cursor, end);
+        position = skipBlanks(cursor, lineEnd);
+    }
+
+    // Parse the size, alone on its line
+    uint32_t size;
+    std::from_chars_result result = std::from_chars(position, lineEnd, size);
+    if (result.ec == std::errc::invalid_argument) {
+        throw ParseError(line, position - cursor + 1, "expected the size of the matrix");
+    }
+    if (result.ec == std::errc::result_out_of_range) {
+        throw ParseError(line, position - cursor + 1, "the size of the matrix is too large");
+    }
+    if (size == 0) {
+        throw ParseError(line, position - cursor + 1, "the size of the matrix must be positive");
+    }
+    position = skipBlanks(result.ptr, lineEnd);
+    if (position != lineEnd) {
+        throw ParseError(line, position - cursor + 1, "unexpected character " + describe(*position) + " after the size of the matrix");
+    }
+
+    // The rows start on the next line
+    rowsOffset = lineEnd == end ? length : lineEnd + 1 - text;
+    rowsLine = line + 1;
+    return size;
+}
+
+MatriceParser::Values MatriceParser::parseRows(uint32_t size, int32_t* data, uint32_t stride, uint32_t threads)
+{
+    // Choose the number of chunks, so that each thread has enough work to be worth starting
+    const char* begin = text + rowsOffset;
+    const char* end = text + length;
+    size_t bytes = end - begin;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::max<size_t>(1, std::min<size_t>(threads, bytes / PARSER_MIN_CHUNK));
+
+    // Split the rows in chunks of about the same size, each one starting at the beginning of a line
+    std::vector<Chunk> chunks(count);
+    const char* chunkBegin = begin;
+    for (size_t index = 0; index < count; index++) {
+        const char* chunkEnd = end;
+        if (index + 1 < count) {
+            chunkEnd = std::max(chunkBegin, begin + bytes / count * (index + 1));
+            chunkEnd = std::min(findLineEnd(chunkEnd, end) + 1, end);
+        }
+        chunks[index].begin = chunkBegin;
+        chunks[index].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    // Find the first line and row of each chunk, by counting those of the previous chunks
+    if (count > 1) {
+        forEachChunk(chunks, [&](size_t index) { countRows(chunks[index]); });
+    }
+    uint64_t line = rowsLine;
+    uint64_t row = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.line = line;
+        chunk.row = row;
+        line += chunk.lines;
+        row += chunk.rows;
+    }
+
+    // Parse the chunks, and report the first error in text order
+    forEachChunk(chunks, [&](size_t index) { parseChunk(chunks[index], size, data, stride); });
+    Values values;
+    line = rowsLine;
+    row = 0;
+    for (Chunk& chunk : chunks) {
+        if (chunk.error) std::rethrow_exception(chunk.error);
+        line += chunk.lines;
+        row += chunk.rows;
+        values.min = std::min(values.min, chunk.values.min);
+        values.max = std::max(values.max, chunk.values.max);
+        values.nonZero += chunk.values.nonZero;
+    }
+
+    // Check that every row was found
+    if (row != size) {
+        throw ParseError(line, 1, "expected " + std::to_string(size) + " rows, found " + std::to_string(row));
+    }
+    return values;
+}
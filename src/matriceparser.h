@@ -0,0 +1,121 @@
+#ifndef MATRICEPARSER_H
+#define MATRICEPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#define PARSER_MIN_CHUNK (1 << 20)  // Minimum number of bytes parsed by each thread (smaller inputs use less threads)
+
+/**
+ * @brief An error in the text of a matrix, with its position in the text.
+ */
+class ParseError : public std::runtime_error
+{
+
+public:
+    /**
+     * @brief Construct a new ParseError object.
+     * The message is prefixed with the position of the error (ex. "Line 3, column 7: expected an integer").
+     * @param line The line of the error (starting at 1).
+     * @param column The column of the error, in bytes (starting at 1).
+     * @param message The description of the error.
+     */
+    ParseError(uint64_t line, uint64_t column, const std::string& message);
+
+    /**
+     * @brief Get the line of the error (starting at 1).
+     * @return The line of the error.
+     */
+    uint64_t getLine() const;
+
+    /**
+     * @brief Get the column of the error, in bytes (starting at 1).
+     * @return The column of the error.
+     */
+    uint64_t getColumn() const;
+
+private:
+    /**
+     * @brief The line of the error (starting at 1).
+     */
+    uint64_t line;
+
+    /**
+     * @brief The column of the error, in bytes (starting at 1).
+     */
+    uint64_t column;
+};
+
+/**
+ * @brief A parser for the text format of matrices: the size of the matrix on the first line,
+ * followed by one row per line, each value being an int32_t separated by spaces (blank lines are ignored).
+ * The text is not copied, and rows are split in chunks of whole lines parsed in parallel.
+ */
+class MatriceParser
+{
+
+public:
+    /**
+     * @brief Statistics about the parsed values, used to choose how to store them.
+     */
+    struct Values {
+        int32_t min = 0;       // The smallest value (0 if every value is positive)
+        int32_t max = 0;       // The largest value (0 if every value is negative)
+        uint64_t nonZero = 0;  // The number of non-zero values
+    };
+
+    /**
+     * @brief Construct a new MatriceParser object.
+     * @param text The text to parse (it must stay valid while parsing).
+     * @param length The length of the text, in bytes.
+     */
+    MatriceParser(const char* text, size_t length);
+
+    /**
+     * @brief Parse the size of the matrix (first non-blank line of the text).
+     * @return The size of the matrix.
+     * @throws ParseError if the first line is not a single positive integer.
+     */
+    uint32_t parseSize();
+
+    /**
+     * @brief Parse the rows of the matrix (every line after the size), in parallel.
+     * `parseSize` must have been called before.
+     * @param size The size of the matrix (returned by `parseSize`).
+     * @param data The buffer to store the values in (row `i` starts at `data + i * stride`).
+     * @param stride The number of values between the start of two consecutive rows of the buffer.
+     * @param threads The maximum number of threads to use (0 to use every hardware thread).
+     * @return Statistics about the parsed values.
+     * @throws ParseError at the first (in text order) malformed value, or if the number of rows or values per row is not `size`.
+     */
+    Values parseRows(uint32_t size, int32_t* data, uint32_t stride, uint32_t threads = 0);
+
+private:
+    /*************
+    | Attributes |
+    *************/
+
+    /**
+     * @brief The text to parse.
+     */
+    const char* text;
+
+    /**
+     * @brief The length of the text, in bytes.
+     */
+    size_t length;
+
+    /**
+     * @brief The position of the first row in the text (set by `parseSize`).
+     */
+    size_t rowsOffset;
+
+    /**
+     * @brief The line of the first row (set by `parseSize`).
+     */
+    uint64_t rowsLine;
+};
+
+#endif // MATRICEPARSER_H
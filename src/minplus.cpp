@@ -0,0 +1,244 @@
+#include "minplus.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**********
+| Kernels |
+**********/
+
+namespace {
+
+/**
+ * @brief The scalar kernel, also used for the last cells of the SIMD kernels.
+ * The sum wraps around when `rowK[j]` is infinite (unsigned, so without undefined behavior), but is then replaced by infinity.
+ */
+template<typename T>
+void minPlusScalar(T* rowI, const T* rowK, T pathIK, uint32_t count)
+{
+    using U = std::make_unsigned_t<T>;
+    const T infinity = std::numeric_limits<T>::max();
+    for (uint32_t j = 0; j < count; j++) {
+        T pathKJ = rowK[j];
+        T length = static_cast<T>(static_cast<U>(pathIK) + static_cast<U>(pathKJ));
+        length = pathKJ == infinity ? infinity : length;
+        rowI[j] = std::min(rowI[j], length);
+    }
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief The SSE 4.2 kernel (16 bytes per step): infinite cells of `rowK` are found with a comparison,
+ * and their (wrapped around) sums are replaced by infinity with a blend before taking the minimum.
+ */
+template<typename T>
+TARGET_SSE42 void minPlusSse42(T* rowI, const T* rowK, T pathIK, uint32_t count)
+{
+    constexpr uint32_t width = sizeof(__m128i) / sizeof(T);
+    __m128i infinity, ik;
+    if constexpr (sizeof(T) == 1) { infinity = _mm_set1_epi8(std::numeric_limits<T>::max()); ik = _mm_set1_epi8(pathIK); }
+    if constexpr (sizeof(T) == 2) { infinity = _mm_set1_epi16(std::numeric_limits<T>::max()); ik = _mm_set1_epi16(pathIK); }
+    if constexpr (sizeof(T) == 4) { infinity = _mm_set1_epi32(std::numeric_limits<T>::max()); ik = _mm_set1_epi32(pathIK); }
+    if constexpr (sizeof(T) == 8) { infinity = _mm_set1_epi64x(std::numeric_limits<T>::max()); ik = _mm_set1_epi64x(pathIK); }
+
+    uint32_t j = 0;
+    for (; j + width <= count; j += width) {
+        __m128i kj = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowK + j));
+        __m128i ij = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowI + j));
+        __m128i length, result;
+        if constexpr (sizeof(T) == 1) {
+            length = _mm_blendv_epi8(_mm_add_epi8(ik, kj), infinity, _mm_cmpeq_epi8(kj, infinity));
+            result = _mm_min_epi8(ij, length);
+        }
+        if constexpr (sizeof(T) == 2) {
+            length = _mm_blendv_epi8(_mm_add_epi16(ik, kj), infinity, _mm_cmpeq_epi16(kj, infinity));
+            result = _mm_min_epi16(ij, length);
+        }
+        if constexpr (sizeof(T) == 4) {
+            length = _mm_blendv_epi8(_mm_add_epi32(ik, kj), infinity, _mm_cmpeq_epi32(kj, infinity));
+            result = _mm_min_epi32(ij, length);
+        }
+        if constexpr (sizeof(T) == 8) {
+            length = _mm_blendv_epi8(_mm_add_epi64(ik, kj), infinity, _mm_cmpeq_epi64(kj, infinity));
+            result = _mm_blendv_epi8(ij, length, _mm_cmpgt_epi64(ij, length));  // No 64-bit minimum before AVX-512
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rowI + j), result);
+    }
+    minPlusScalar(rowI + j, rowK + j, pathIK, count - j);
+}
+
+/**
+ * @brief The AVX2 kernel (32 bytes per step), same as the SSE 4.2 one with wider vectors.
+ */
+template<typename T>
+TARGET_AVX2 void minPlusAvx2(T* rowI, const T* rowK, T pathIK, uint32_t count)
+{
+    constexpr uint32_t width = sizeof(__m256i) / sizeof(T);
+    __m256i infinity, ik;
+    if constexpr (sizeof(T) == 1) { infinity = _mm256_set1_epi8(std::numeric_limits<T>::max()); ik = _mm256_set1_epi8(pathIK); }
+    if constexpr (sizeof(T) == 2) { infinity = _mm256_set1_epi16(std::numeric_limits<T>::max()); ik = _mm256_set1_epi16(pathIK); }
+    if constexpr (sizeof(T) == 4) { infinity = _mm256_set1_epi32(std::numeric_limits<T>::max()); ik = _mm256_set1_epi32(pathIK); }
+    if constexpr (sizeof(T) == 8) { infinity = _mm256_set1_epi64x(std::numeric_limits<T>::max()); ik = _mm256_set1_epi64x(pathIK); }
+
+    uint32_t j = 0;
+    for (; j + width <= count; j += width) {
+        __m256i kj = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowK + j));
+        __m256i ij = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowI + j));
+        __m256i length, result;
+        if constexpr (sizeof(T) == 1) {
+            length = _mm256_blendv_epi8(_mm256_add_epi8(ik, kj), infinity, _mm256_cmpeq_epi8(kj, infinity));
+            result = _mm256_min_epi8(ij, length);
+        }
+        if constexpr (sizeof(T) == 2) {
+            length = _mm256_blendv_epi8(_mm256_add_epi16(ik, kj), infinity, _mm256_cmpeq_epi16(kj, infinity));
+            result = _mm256_min_epi16(ij, length);
+        }
+        if constexpr (sizeof(T) == 4) {
+            length = _mm256_blendv_epi8(_mm256_add_epi32(ik, kj), infinity, _mm256_cmpeq_epi32(kj, infinity));
+            result = _mm256_min_epi32(ij, length);
+        }
+        if constexpr (sizeof(T) == 8) {
+            length = _mm256_blendv_epi8(_mm256_add_epi64(ik, kj), infinity, _mm256_cmpeq_epi64(kj, infinity));
+            result = _mm256_blendv_epi8(ij, length, _mm256_cmpgt_epi64(ij, length));  // No 64-bit minimum before AVX-512
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rowI + j), result);
+    }
+    minPlusScalar(rowI + j, rowK + j, pathIK, count - j);
+}
+
+/**
+ * @brief The AVX-512 kernel (64 bytes per step, a whole cache line): the comparison gives a mask,
+ * and the minimum is only taken for the cells where `rowK` is finite (the others keep the value of `rowI`).
+ */
+template<typename T>
+TARGET_AVX512 void minPlusAvx512(T* rowI, const T* rowK, T pathIK, uint32_t count)
+{
+    constexpr uint32_t width = sizeof(__m512i) / sizeof(T);
+    __m512i infinity, ik;
+    if constexpr (sizeof(T) == 1) { infinity = _mm512_set1_epi8(std::numeric_limits<T>::max()); ik = _mm512_set1_epi8(pathIK); }
+    if constexpr (sizeof(T) == 2) { infinity = _mm512_set1_epi16(std::numeric_limits<T>::max()); ik = _mm512_set1_epi16(pathIK); }
+    if constexpr (sizeof(T) == 4) { infinity = _mm512_set1_epi32(std::numeric_limits<T>::max()); ik = _mm512_set1_epi32(pathIK); }
+    if constexpr (sizeof(T) == 8) { infinity = _mm512_set1_epi64(std::numeric_limits<T>::max()); ik = _mm512_set1_epi64(pathIK); }
+
+    uint32_t j = 0;
+    for (; j + width <= count; j += width) {
+        __m512i kj = _mm512_loadu_si512(rowK + j);
+        __m512i ij = _mm512_loadu_si512(rowI + j);
+        __m512i result;
+        if constexpr (sizeof(T) == 1) result = _mm512_mask_min_epi8(ij, _mm512_cmpneq_epi8_mask(kj, infinity), ij, _mm512_add_epi8(ik, kj));
+        if constexpr (sizeof(T) == 2) result = _mm512_mask_min_epi16(ij, _mm512_cmpneq_epi16_mask(kj, infinity), ij, _mm512_add_epi16(ik, kj));
+        if constexpr (sizeof(T) == 4) result = _mm512_mask_min_epi32(ij, _mm512_cmpneq_epi32_mask(kj, infinity), ij, _mm512_add_epi32(ik, kj));
+        if constexpr (sizeof(T) == 8) result = _mm512_mask_min_epi64(ij, _mm512_cmpneq_epi64_mask(kj, infinity), ij, _mm512_add_epi64(ik, kj));
+        _mm512_storeu_si512(rowI + j, result);
+    }
+    minPlusScalar(rowI + j, rowK + j, pathIK, count - j);
+}
+
+#endif
+
+/**
+ * @brief The kernel keeping track of the next hops: a cell (and its next hop) is only replaced by a strictly shorter path.
+ * There is no intrinsic version, as each pair of path and hop types would need its own: the loop is written without branches
+ * instead, so that the compiler vectorizes it for the instruction set of each instantiation (see `minPlusHopsKernel`).
+ */
+template<typename T, typename H>
+inline void minPlusHops(T* __restrict rowI, const T* __restrict rowK, T pathIK, H* __restrict hopsI, H hopIK, uint32_t count)
+{
+    using U = std::make_unsigned_t<T>;
+    const T infinity = std::numeric_limits<T>::max();
+    for (uint32_t j = 0; j < count; j++) {
+        T pathKJ = rowK[j];
+        T length = static_cast<T>(static_cast<U>(pathIK) + static_cast<U>(pathKJ));
+        bool shorter = (pathKJ != infinity) & (length < rowI[j]);
+        rowI[j] = shorter ? length : rowI[j];
+        hopsI[j] = shorter ? hopIK : hopsI[j];
+    }
+}
+
+template<typename T, typename H>
+void minPlusHopsScalar(T* rowI, const T* rowK, T pathIK, H* hopsI, H hopIK, uint32_t count)
+{
+    minPlusHops(rowI, rowK, pathIK, hopsI, hopIK, count);
+}
+
+#ifdef SIMD_X86
+
+template<typename T, typename H>
+TARGET_SSE42 void minPlusHopsSse42(T* rowI, const T* rowK, T pathIK, H* hopsI, H hopIK, uint32_t count)
+{
+    minPlusHops(rowI, rowK, pathIK, hopsI, hopIK, count);
+}
+
+template<typename T, typename H>
+TARGET_AVX2 void minPlusHopsAvx2(T* rowI, const T* rowK, T pathIK, H* hopsI, H hopIK, uint32_t count)
+{
+    minPlusHops(rowI, rowK, pathIK, hopsI, hopIK, count);
+}
+
+template<typename T, typename H>
+TARGET_AVX512 void minPlusHopsAvx512(T* rowI, const T* rowK, T pathIK, H* hopsI, H hopIK, uint32_t count)
+{
+    minPlusHops(rowI, rowK, pathIK, hopsI, hopIK, count);
+}
+
+#endif
+
+}
+
+/*************
+| Dispatcher |
+*************/
+
+template<typename T>
+MinPlusKernel<T> minPlusKernel(SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512: return &minPlusAvx512<T>;
+        case SimdLevel::AVX2:   return &minPlusAvx2<T>;
+        case SimdLevel::SSE42:  return &minPlusSse42<T>;
+        default:                return &minPlusScalar<T>;
+    }
+#else
+    (void)level;
+    return &minPlusScalar<T>;
+#endif
+}
+
+template<typename T, typename H>
+MinPlusHopsKernel<T, H> minPlusHopsKernel(SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512: return &minPlusHopsAvx512<T, H>;
+        case SimdLevel::AVX2:   return &minPlusHopsAvx2<T, H>;
+        case SimdLevel::SSE42:  return &minPlusHopsSse42<T, H>;
+        default:                return &minPlusHopsScalar<T, H>;
+    }
+#else
+    (void)level;
+    return &minPlusHopsScalar<T, H>;
+#endif
+}
+
+template MinPlusKernel<int8_t> minPlusKernel<int8_t>(SimdLevel level);
+template MinPlusKernel<int16_t> minPlusKernel<int16_t>(SimdLevel level);
+template MinPlusKernel<int32_t> minPlusKernel<int32_t>(SimdLevel level);
+template MinPlusKernel<int64_t> minPlusKernel<int64_t>(SimdLevel level);
+
+// Every pair of path and hop types (see `dispatchCellType`)
+#define INSTANTIATE_HOPS_KERNEL(T) \
+    template MinPlusHopsKernel<T, int8_t> minPlusHopsKernel<T, int8_t>(SimdLevel level); \
+    template MinPlusHopsKernel<T, int16_t> minPlusHopsKernel<T, int16_t>(SimdLevel level); \
+    template MinPlusHopsKernel<T, int32_t> minPlusHopsKernel<T, int32_t>(SimdLevel level); \
+    template MinPlusHopsKernel<T, int64_t> minPlusHopsKernel<T, int64_t>(SimdLevel level);
+INSTANTIATE_HOPS_KERNEL(int8_t)
+INSTANTIATE_HOPS_KERNEL(int16_t)
+INSTANTIATE_HOPS_KERNEL(int32_t)
+INSTANTIATE_HOPS_KERNEL(int64_t)
@@ -0,0 +1,42 @@
+#ifndef MINPLUS_H
+#define MINPLUS_H
+
+#include "hardware.h"
+
+#include <cstdint>
+
+/**
+ * @brief A min-plus kernel, relaxing a row of paths through an intermediate node `k`:
+ * for each j in [0, count), rowI[j] = min(rowI[j], pathIK + rowK[j]).
+ * The maximum of `T` is infinity: infinite cells of `rowK` leave `rowI` unchanged, without any branch.
+ * `rowI` and `rowK` must not overlap, `pathIK` must be finite, and finite sums must fit in `T`.
+ */
+template<typename T>
+using MinPlusKernel = void (*)(T* rowI, const T* rowK, T pathIK, uint32_t count);
+
+/**
+ * @brief Get the min-plus kernel using the given SIMD instruction set.
+ * Every kernel gives the same result, only their speed differs.
+ * @param level The SIMD level (it must be supported by the processor, see `simdLevel`). Defaults to the newest supported one.
+ * @return The kernel (the scalar one if the level is not compiled in, ex. on non-x86 processors).
+ */
+template<typename T>
+MinPlusKernel<T> minPlusKernel(SimdLevel level = simdLevel());
+
+/**
+ * @brief A min-plus kernel also keeping track of the next hops of the paths (see `Matrice::floydWarshall`):
+ * for each j in [0, count) such that pathIK + rowK[j] < rowI[j], rowI[j] = pathIK + rowK[j] and hopsI[j] = hopIK.
+ * Same requirements as `MinPlusKernel`, and `hopsI` must not overlap the rows either.
+ */
+template<typename T, typename H>
+using MinPlusHopsKernel = void (*)(T* rowI, const T* rowK, T pathIK, H* hopsI, H hopIK, uint32_t count);
+
+/**
+ * @brief Get the min-plus kernel keeping track of the next hops, for the given SIMD instruction set.
+ * @param level The SIMD level (it must be supported by the processor, see `simdLevel`). Defaults to the newest supported one.
+ * @return The kernel (the scalar one if the level is not compiled in, ex. on non-x86 processors).
+ */
+template<typename T, typename H>
+MinPlusHopsKernel<T, H> minPlusHopsKernel(SimdLevel level = simdLevel());
+
+#endif // MINPLUS_H
@@ -0,0 +1,232 @@
+#include "primkernels.h"
+
+#include "celltype.h"
+
+#include <limits>
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/**********
+| Kernels |
+**********/
+
+namespace {
+
+/**
+ * @brief The relaxation kernel, written without branches so that the compiler vectorizes it for the instruction set
+ * of each instantiation (see `primRelaxKernel`): the distances and the parents are always written back, with either
+ * their previous value or the new one.
+ */
+template<typename T>
+inline void primRelax(int64_t* __restrict distances, uint32_t* __restrict parents, const T* __restrict row, uint32_t parent, uint32_t count)
+{
+    const T infinity = std::numeric_limits<T>::max();
+    for (uint32_t j = 0; j < count; j++) {
+        T cell = row[j];
+        int64_t weight = cell;
+        bool closer = (cell != 0) & (cell != infinity) & (weight < distances[j]);
+        distances[j] = closer ? weight : distances[j];
+        parents[j] = closer ? parent : parents[j];
+    }
+}
+
+template<typename T>
+void primRelaxScalar(int64_t* distances, uint32_t* parents, const T* row, uint32_t parent, uint32_t count)
+{
+    primRelax(distances, parents, row, parent, count);
+}
+
+/**
+ * @brief The key compared by the selection kernels: the distance minus 1 (unsigned, so without undefined behavior).
+ * The nodes in the tree (INT64_MIN) wrap around to INT64_MAX, after every other node, while the order of the other distances is kept.
+ */
+inline int64_t primKey(int64_t distance)
+{
+    return static_cast<int64_t>(static_cast<uint64_t>(distance) - 1);
+}
+
+/**
+ * @brief Find the first index in [begin, count) whose key is `best` (`count` if there is none).
+ */
+uint32_t primFind(const int64_t* distances, uint32_t begin, uint32_t count, int64_t best)
+{
+    for (uint32_t j = begin; j < count; j++) {
+        if (primKey(distances[j]) == best) return j;
+    }
+    return count;
+}
+
+/**
+ * @brief The scalar selection kernel: the smallest key is found first, then its first index, so that both loops are simple
+ * (the SIMD kernels do the same, a vector at a time).
+ */
+uint32_t primArgminScalar(const int64_t* distances, uint32_t count)
+{
+    int64_t best = INT64_MAX;
+    for (uint32_t j = 0; j < count; j++) {
+        int64_t key = primKey(distances[j]);
+        best = key < best ? key : best;
+    }
+    return best == INT64_MAX ? count : primFind(distances, 0, count, best);
+}
+
+#ifdef SIMD_X86
+
+template<typename T>
+TARGET_SSE42 void primRelaxSse42(int64_t* distances, uint32_t* parents, const T* row, uint32_t parent, uint32_t count)
+{
+    primRelax(distances, parents, row, parent, count);
+}
+
+template<typename T>
+TARGET_AVX2 void primRelaxAvx2(int64_t* distances, uint32_t* parents, const T* row, uint32_t parent, uint32_t count)
+{
+    primRelax(distances, parents, row, parent, count);
+}
+
+template<typename T>
+TARGET_AVX512 void primRelaxAvx512(int64_t* distances, uint32_t* parents, const T* row, uint32_t parent, uint32_t count)
+{
+    primRelax(distances, parents, row, parent, count);
+}
+
+/**
+ * @brief The SSE 4.2 selection kernel (2 distances per step): there is no 64-bit minimum before AVX-512,
+ * so it is a comparison followed by a blend.
+ */
+TARGET_SSE42 uint32_t primArgminSse42(const int64_t* distances, uint32_t count)
+{
+    const __m128i one = _mm_set1_epi64x(1);
+    __m128i best = _mm_set1_epi64x(INT64_MAX);
+    uint32_t j = 0;
+    for (; j + 2 <= count; j += 2) {
+        __m128i key = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(distances + j)), one);
+        best = _mm_blendv_epi8(best, key, _mm_cmpgt_epi64(best, key));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), best);
+    int64_t result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    for (; j < count; j++) {
+        int64_t key = primKey(distances[j]);
+        result = key < result ? key : result;
+    }
+    if (result == INT64_MAX) return count;
+
+    // Find the first index of the smallest key, 2 distances at a time
+    const __m128i target = _mm_set1_epi64x(result);
+    for (j = 0; j + 2 <= count; j += 2) {
+        __m128i key = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(distances + j)), one);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(key, target)));
+        if (mask != 0) return j + (mask & 1 ? 0 : 1);
+    }
+    return primFind(distances, j, count, result);
+}
+
+/**
+ * @brief The AVX2 selection kernel (4 distances per step), same as the SSE 4.2 one with wider vectors.
+ */
+TARGET_AVX2 uint32_t primArgminAvx2(const int64_t* distances, uint32_t count)
+{
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i best = _mm256_set1_epi64x(INT64_MAX);
+    uint32_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256i key = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(distances + j)), one);
+        best = _mm256_blendv_epi8(best, key, _mm256_cmpgt_epi64(best, key));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), best);
+    int64_t result = INT64_MAX;
+    for (int64_t lane : lanes) result = lane < result ? lane : result;
+    for (; j < count; j++) {
+        int64_t key = primKey(distances[j]);
+        result = key < result ? key : result;
+    }
+    if (result == INT64_MAX) return count;
+
+    // Find the first index of the smallest key, 4 distances at a time
+    const __m256i target = _mm256_set1_epi64x(result);
+    for (j = 0; j + 4 <= count; j += 4) {
+        __m256i key = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(distances + j)), one);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(key, target)));
+        if (mask != 0) return j + countTrailingZeros(mask);
+    }
+    return primFind(distances, j, count, result);
+}
+
+/**
+ * @brief The AVX-512 selection kernel (8 distances per step, a whole cache line), same as the SSE 4.2 one with comparison masks.
+ */
+TARGET_AVX512 uint32_t primArgminAvx512(const int64_t* distances, uint32_t count)
+{
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512i best = _mm512_set1_epi64(INT64_MAX);
+    uint32_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m512i key = _mm512_sub_epi64(_mm512_loadu_si512(distances + j), one);
+        best = _mm512_mask_mov_epi64(best, _mm512_cmpgt_epi64_mask(best, key), key);
+    }
+    int64_t lanes[8];
+    _mm512_storeu_si512(lanes, best);
+    int64_t result = INT64_MAX;
+    for (int64_t lane : lanes) result = lane < result ? lane : result;
+    for (; j < count; j++) {
+        int64_t key = primKey(distances[j]);
+        result = key < result ? key : result;
+    }
+    if (result == INT64_MAX) return count;
+
+    // Find the first index of the smallest key, 8 distances at a time
+    const __m512i target = _mm512_set1_epi64(result);
+    for (j = 0; j + 8 <= count; j += 8) {
+        __mmask8 mask = _mm512_cmpeq_epi64_mask(_mm512_sub_epi64(_mm512_loadu_si512(distances + j), one), target);
+        if (mask != 0) return j + countTrailingZeros(mask);
+    }
+    return primFind(distances, j, count, result);
+}
+
+#endif
+
+}
+
+/*************
+| Dispatcher |
+*************/
+
+template<typename T>
+PrimRelaxKernel<T> primRelaxKernel(SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512: return &primRelaxAvx512<T>;
+        case SimdLevel::AVX2:   return &primRelaxAvx2<T>;
+        case SimdLevel::SSE42:  return &primRelaxSse42<T>;
+        default:                return &primRelaxScalar<T>;
+    }
+#else
+    (void)level;
+    return &primRelaxScalar<T>;
+#endif
+}
+
+PrimArgminKernel primArgminKernel(SimdLevel level)
+{
+#ifdef SIMD_X86
+    switch (level) {
+        case SimdLevel::AVX512: return &primArgminAvx512;
+        case SimdLevel::AVX2:   return &primArgminAvx2;
+        case SimdLevel::SSE42:  return &primArgminSse42;
+        default:                return &primArgminScalar;
+    }
+#else
+    (void)level;
+    return &primArgminScalar;
+#endif
+}
+
+template PrimRelaxKernel<int8_t> primRelaxKernel<int8_t>(SimdLevel level);
+template PrimRelaxKernel<int16_t> primRelaxKernel<int16_t>(SimdLevel level);
+template PrimRelaxKernel<int32_t> primRelaxKernel<int32_t>(SimdLevel level);
+template PrimRelaxKernel<int64_t> primRelaxKernel<int64_t>(SimdLevel level);
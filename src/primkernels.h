@@ -0,0 +1,42 @@
+#ifndef PRIMKERNELS_H
+#define PRIMKERNELS_H
+
+#include "hardware.h"
+
+#include <cstdint>
+
+/**
+ * @brief A relaxation kernel of Prim's algorithm, lowering the distances to the tree with a row of the node just added:
+ * for each j in [0, count) such that row[j] is an edge (neither 0 nor the maximum of `T`, which is infinity) shorter than distances[j],
+ * distances[j] = row[j] and parents[j] = parent.
+ * The nodes already in the tree have a distance of INT64_MIN, so that they are never updated, without any branch.
+ * `distances`, `parents` and `row` must not overlap.
+ */
+template<typename T>
+using PrimRelaxKernel = void (*)(int64_t* distances, uint32_t* parents, const T* row, uint32_t parent, uint32_t count);
+
+/**
+ * @brief Get the relaxation kernel of Prim's algorithm using the given SIMD instruction set.
+ * Every kernel gives the same result, only their speed differs.
+ * @param level The SIMD level (it must be supported by the processor, see `simdLevel`). Defaults to the newest supported one.
+ * @return The kernel (the scalar one if the level is not compiled in, ex. on non-x86 processors).
+ */
+template<typename T>
+PrimRelaxKernel<T> primRelaxKernel(SimdLevel level = simdLevel());
+
+/**
+ * @brief A selection kernel of Prim's algorithm, finding the next node to add to the tree:
+ * the first index of the smallest distance in [0, count), skipping the nodes already in the tree (INT64_MIN).
+ * If no node is connected to the tree, it is the first node left (all at INT64_MAX), which starts a new tree.
+ * Returns `count` if every node is in the tree.
+ */
+using PrimArgminKernel = uint32_t (*)(const int64_t* distances, uint32_t count);
+
+/**
+ * @brief Get the selection kernel of Prim's algorithm using the given SIMD instruction set.
+ * @param level The SIMD level (it must be supported by the processor, see `simdLevel`). Defaults to the newest supported one.
+ * @return The kernel (the scalar one if the level is not compiled in, ex. on non-x86 processors).
+ */
+PrimArgminKernel primArgminKernel(SimdLevel level = simdLevel());
+
+#endif // PRIMKERNELS_H
@@ -0,0 +1,207 @@
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+
+#define PROGRESS_STEPS 1000  // Maximum number of calls of a progress callback per algorithm (one per step of 1/1000 of the work)
+
+/**
+ * @brief A flag asking a running algorithm to stop, which can be raised from any thread (see `ProgressHooks`).
+ */
+class CancellationToken
+{
+public:
+    /**
+     * @brief Ask the algorithms using this token to stop (they throw `CancelledError` at their next progress step).
+     */
+    void cancel()
+    {
+        cancelled.store(true);
+    }
+
+    /**
+     * @brief Lower the flag, to use the token for another algorithm.
+     */
+    void reset()
+    {
+        cancelled.store(false);
+    }
+
+    /**
+     * @brief Check whether the algorithms using this token were asked to stop.
+     * @return True if `cancel` was called (and not `reset` since).
+     */
+    bool isCancelled() const
+    {
+        return cancelled.load();
+    }
+
+private:
+    /**
+     * @brief Whether the algorithms were asked to stop.
+     */
+    std::atomic<bool> cancelled{false};
+};
+
+/**
+ * @brief The exception thrown by an algorithm stopped by its cancellation token (everything it allocated is freed first).
+ */
+class CancelledError : public std::runtime_error
+{
+public:
+    CancelledError():
+        std::runtime_error("The computation was cancelled.")
+    {}
+};
+
+/**
+ * @brief The optional hooks of the long algorithms of `Matrice` (ex. `Matrice::floydWarshall`), both optional too:
+ * a progress callback, and a cancellation token checked at each step of the algorithm.
+ */
+struct ProgressHooks {
+    /**
+     * @brief Called with the work done and the total work (in units of the algorithm, ex. nodes), on the thread running the algorithm,
+     * at most PROGRESS_STEPS times. `done` never decreases, and only reaches `total` if the algorithm ends its last step.
+     */
+    std::function<void(uint64_t done, uint64_t total)> progress;
+
+    /**
+     * @brief The token asking the algorithm to stop, or nullptr if it cannot be cancelled.
+     */
+    const CancellationToken* cancellation = nullptr;
+};
+
+/**
+ * @brief The progress policy of the algorithms run without hooks: every call is a constant, so that the compiler removes them
+ * (and the checks around them) from the loops of the algorithms.
+ */
+struct NoProgress
+{
+    /**
+     * @brief Report the work done so far, and check whether the algorithm must stop.
+     * @return Always true (go on).
+     */
+    constexpr bool report(uint64_t) const { return true; }
+
+    /**
+     * @brief Check whether a report asked the algorithm to stop.
+     * @return Always false.
+     */
+    constexpr bool stopped() const { return false; }
+
+    /**
+     * @brief Set the work done before the current step of the algorithm (unused).
+     */
+    void setOffset(uint64_t) {}
+};
+
+/**
+ * @brief The progress policy of the algorithms run with hooks: each report checks the cancellation token (a single atomic load),
+ * and calls the progress callback once every 1/PROGRESS_STEPS of the total work.
+ */
+class HookedProgress
+{
+public:
+    /**
+     * @brief Construct a new HookedProgress object.
+     * @param hooks The hooks (they must outlive this object).
+     * @param total The total work of the algorithm.
+     */
+    HookedProgress(const ProgressHooks& hooks, uint64_t total):
+        hooks(hooks),
+        total(total),
+        step(total / PROGRESS_STEPS + 1)
+    {}
+
+    /**
+     * @brief Report the work done so far (after the offset, see `setOffset`), and check whether the algorithm must stop.
+     * @param done The work done.
+     * @return False if the algorithm must stop (it must then free what it allocated and throw `CancelledError`), true otherwise.
+     */
+    bool report(uint64_t done)
+    {
+        if (hooks.cancellation != nullptr && hooks.cancellation->isCancelled()) cancelled = true;
+        if (cancelled) return false;
+
+        done += offset;
+        if (hooks.progress && (done >= nextReport || done == total)) {
+            hooks.progress(done, total);
+            nextReport = done + step;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Check whether a report asked the algorithm to stop.
+     * @return True if `report` returned false.
+     */
+    bool stopped() const
+    {
+        return cancelled;
+    }
+
+    /**
+     * @brief Set the work done before the current step of the algorithm, when it runs several algorithms in a row
+     * (ex. `Matrice::clusterMatrice` finds the clusters, then counts the edges between them).
+     * @param offset The work done by the previous steps.
+     */
+    void setOffset(uint64_t offset)
+    {
+        this->offset = offset;
+    }
+
+private:
+    /**
+     * @brief The hooks of the algorithm.
+     */
+    const ProgressHooks& hooks;
+
+    /**
+     * @brief The total work of the algorithm.
+     */
+    uint64_t total;
+
+    /**
+     * @brief The work between two calls of the progress callback.
+     */
+    uint64_t step;
+
+    /**
+     * @brief The work after which the progress callback is called again.
+     */
+    uint64_t nextReport = 0;
+
+    /**
+     * @brief The work done by the previous steps of the algorithm.
+     */
+    uint64_t offset = 0;
+
+    /**
+     * @brief Whether a report asked the algorithm to stop.
+     */
+    bool cancelled = false;
+};
+
+/**
+ * @brief Run an algorithm with the progress policy matching its hooks: `NoProgress` without hooks, so that the algorithm is compiled
+ * without any check, and `HookedProgress` otherwise.
+ * @param hooks The hooks, or nullptr.
+ * @param total The total work of the algorithm.
+ * @param function The algorithm, called with the policy (`auto& progress`).
+ * @return The result of the algorithm.
+ */
+template<typename Function>
+auto runWithProgress(const ProgressHooks* hooks, uint64_t total, Function&& function)
+{
+    if (hooks == nullptr) {
+        NoProgress progress;
+        return function(progress);
+    }
+    HookedProgress progress(*hooks, total);
+    return function(progress);
+}
+
+#endif // PROGRESS_H
@@ -0,0 +1,111 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * @brief A radix min-heap of values with unsigned integer keys, for monotone uses such as Dijkstra's algorithm:
+ * a pushed key must never be smaller than the last popped one. Items are put in 65 buckets, by the highest bit in which
+ * their key differs from the last popped key, so each item only moves down a few buckets before being popped, without any comparison.
+ * There is no decrease-key: push the value again with its smaller key, and skip the outdated item when it is popped.
+ */
+template<typename Value>
+class RadixHeap
+{
+public:
+    /**
+     * @brief An item of the heap.
+     */
+    struct Item {
+        uint64_t key;
+        Value value;
+    };
+
+    /**
+     * @brief Check whether the heap is empty.
+     */
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Insert an item.
+     * @param key The key of the item (not smaller than the last popped key).
+     * @param value The value of the item.
+     */
+    void push(uint64_t key, Value value)
+    {
+        buckets[bucketIndex(key)].push_back({key, value});
+        count++;
+    }
+
+    /**
+     * @brief Remove an item with the smallest key.
+     * @return The removed item (the heap must not be empty).
+     */
+    Item pop()
+    {
+        // The first bucket holds the items whose key is the last popped one: refill it from the first non-empty bucket,
+        // whose smallest key becomes the reference (every other item of the bucket then moves to a lower bucket)
+        if (buckets[0].empty()) {
+            uint32_t index = 1;
+            while (buckets[index].empty()) index++;
+            uint64_t min = buckets[index][0].key;
+            for (const Item& item : buckets[index]) {
+                if (item.key < min) min = item.key;
+            }
+            last = min;
+            for (const Item& item : buckets[index]) buckets[bucketIndex(item.key)].push_back(item);
+            buckets[index].clear();
+        }
+        Item item = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return item;
+    }
+
+private:
+    /**
+     * @brief Get the bucket of a key: 0 if it is the last popped key, otherwise 1 + the highest bit in which they differ.
+     */
+    uint32_t bucketIndex(uint64_t key) const
+    {
+        uint64_t difference = key ^ last;
+        if (difference == 0) return 0;
+#if defined(__GNUC__)
+        return 64 - static_cast<uint32_t>(__builtin_clzll(difference));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long bit;
+        _BitScanReverse64(&bit, difference);
+        return static_cast<uint32_t>(bit) + 1;
+#else
+        uint32_t index = 0;
+        while (difference != 0) {
+            difference >>= 1;
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    /**
+     * @brief The items, by bucket (see `bucketIndex`).
+     */
+    std::vector<Item> buckets[65];
+
+    /**
+     * @brief The last popped key (0 before the first pop).
+     */
+    uint64_t last = 0;
+
+    /**
+     * @brief The number of items in the heap.
+     */
+    size_t count = 0;
+};
+
+#endif // RADIXHEAP_H
@@ -0,0 +1,113 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+/******************************
+| Constructors and Destructor |
+******************************/
+
+ThreadPool::ThreadPool(uint32_t threads)
+{
+    // The calling thread runs iterations as well, so one less thread is started
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t i = 1; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+/**********************
+| Getters and Setters |
+**********************/
+
+uint32_t ThreadPool::getThreadCount() const
+{
+    return workers.size() + 1;
+}
+
+/************
+| Execution |
+************/
+
+void ThreadPool::parallelFor(uint64_t count, const std::function<void(uint64_t)>& function)
+{
+    // Small loops (and pools of a single thread) are run directly
+    if (workers.empty() || count <= 1) {
+        for (uint64_t i = 0; i < count; i++) {
+            function(i);
+        }
+        return;
+    }
+
+    // Publish the loop and wake the threads
+    std::lock_guard<std::mutex> loop(running);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->function = &function;
+        this->count = count;
+        next = 0;
+        pending = workers.size();
+        error = nullptr;
+        generation++;
+    }
+    started.notify_all();
+
+    // Run iterations as well, then wait for the threads to finish theirs
+    runIterations();
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return pending == 0; });
+    this->function = nullptr;
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+void ThreadPool::work()
+{
+    uint64_t seen = 0;
+    while (true) {
+        // Wait for a new loop
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        // Run its iterations, and tell the calling thread when done
+        runIterations();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) finished.notify_one();
+    }
+}
+
+void ThreadPool::runIterations()
+{
+    for (uint64_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        try {
+            (*function)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of threads, used to run the iterations of parallel loops.
+ * The threads are started once, and sleep between loops, so that a loop only costs a wake-up.
+ */
+class ThreadPool
+{
+
+public:
+    /******************************
+    | Constructors and Destructor |
+    ******************************/
+
+    /**
+     * @brief Construct a new ThreadPool object.
+     * @param threads The number of threads running the loops, including the calling thread (0 for every hardware thread).
+     */
+    ThreadPool(uint32_t threads = 0);
+
+    /**
+     * @brief Stop and join the threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Get the pool shared by the whole application, with one thread per hardware thread (created on first use).
+     * @return The shared pool.
+     */
+    static ThreadPool& shared();
+
+    /**********************
+    | Getters and Setters |
+    **********************/
+
+    /**
+     * @brief Get the number of threads running the loops (including the calling thread).
+     * @return The number of threads.
+     */
+    uint32_t getThreadCount() const;
+
+    /************
+    | Execution |
+    ************/
+
+    /**
+     * @brief Call a function for each index from 0 to count - 1, spread over the threads, and wait for all the calls to end.
+     * Indexes are handed out one at a time, so iterations of different lengths are balanced between threads.
+     * Loops started from several threads at once run one after the other, and a loop must not be started from one of its iterations.
+     * @param count The number of iterations.
+     * @param function The function to call, taking the index of the iteration.
+     * @throws The first exception thrown by an iteration (the other iterations still run).
+     */
+    void parallelFor(uint64_t count, const std::function<void(uint64_t)>& function);
+
+private:
+    /**
+     * @brief The loop run by each thread of the pool: wait for a parallel loop, and run its iterations.
+     */
+    void work();
+
+    /**
+     * @brief Run iterations of the current parallel loop until none is left.
+     */
+    void runIterations();
+
+    /*************
+    | Attributes |
+    *************/
+
+    /**
+     * @brief The threads of the pool (the calling thread is not one of them).
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * @brief Ensures that only one parallel loop runs at a time.
+     */
+    std::mutex running;
+
+    /**
+     * @brief Protects the state of the current loop shared with the threads.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief Wakes the threads when a loop starts (or when the pool stops).
+     */
+    std::condition_variable started;
+
+    /**
+     * @brief Wakes the calling thread when every thread finished the current loop.
+     */
+    std::condition_variable finished;
+
+    /**
+     * @brief The function of the current loop.
+     */
+    const std::function<void(uint64_t)>* function = nullptr;
+
+    /**
+     * @brief The number of iterations of the current loop.
+     */
+    uint64_t count = 0;
+
+    /**
+     * @brief The next iteration to run.
+     */
+    std::atomic<uint64_t> next{0};
+
+    /**
+     * @brief The number of the current loop, so that threads know when a new one starts.
+     */
+    uint64_t generation = 0;
+
+    /**
+     * @brief The number of threads still running iterations of the current loop.
+     */
+    uint32_t pending = 0;
+
+    /**
+     * @brief The first exception thrown by an iteration of the current loop.
+     */
+    std::exception_ptr error;
+
+    /**
+     * @brief Whether the threads must stop.
+     */
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
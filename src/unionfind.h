@@ -0,0 +1,139 @@
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A partition of the items 0 to size-1 into disjoint sets (union-find), each set being represented by one of its items.
+ * Sets are merged by size and paths are compressed (halved) while searching, so that any sequence of operations takes
+ * an almost constant time per operation.
+ */
+class UnionFind
+{
+public:
+    /**
+     * @brief Construct a partition where each item is alone in its set.
+     * @param size The number of items.
+     */
+    explicit UnionFind(uint32_t size):
+        parents(size),
+        sizes(size, 1)
+    {
+        for (uint32_t item = 0; item < size; item++) parents[item] = item;
+    }
+
+    /**
+     * @brief Find the representative of the set of an item.
+     * @param item The item.
+     * @return The representative (the same for every item of the set).
+     */
+    uint32_t find(uint32_t item)
+    {
+        // Make each item of the path point to its grandparent, halving the path for the next searches
+        while (parents[item] != item) {
+            parents[item] = parents[parents[item]];
+            item = parents[item];
+        }
+        return item;
+    }
+
+    /**
+     * @brief Merge the sets of two items.
+     * @param a The first item.
+     * @param b The second item.
+     * @return True if the sets were merged, false if the items were already in the same set.
+     */
+    bool unite(uint32_t a, uint32_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+
+        // Attach the smaller set under the larger one, to keep the trees shallow
+        if (sizes[a] < sizes[b]) std::swap(a, b);
+        parents[b] = a;
+        sizes[a] += sizes[b];
+        return true;
+    }
+
+private:
+    /**
+     * @brief The parent of each item in the tree of its set (the representative is its own parent).
+     */
+    std::vector<uint32_t> parents;
+
+    /**
+     * @brief The number of items of each set (only meaningful for representatives).
+     */
+    std::vector<uint32_t> sizes;
+};
+
+/**
+ * @brief Same as `UnionFind`, but `find` and `unite` can be called by several threads at once, without locks.
+ * A representative is linked under another with a compare-and-swap, which fails if it stopped being a representative
+ * in the meantime (the search is then retried). The representative with the largest index is always the one linked,
+ * so that concurrent links can never form a cycle; paths are still halved while searching.
+ */
+class ConcurrentUnionFind
+{
+public:
+    /**
+     * @brief Construct a partition where each item is alone in its set.
+     * @param size The number of items.
+     */
+    explicit ConcurrentUnionFind(uint32_t size):
+        parents(size)
+    {
+        for (uint32_t item = 0; item < size; item++) parents[item].store(item, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Find the representative of the set of an item.
+     * While other threads merge sets, the result may stop being the representative as soon as it is returned.
+     * @param item The item.
+     * @return The representative (the same for every item of the set, once no merge is running).
+     */
+    uint32_t find(uint32_t item)
+    {
+        while (true) {
+            uint32_t parent = parents[item].load(std::memory_order_acquire);
+            if (parent == item) return item;
+
+            // Make the item point to its grandparent if nobody changed its parent (any ancestor is a valid parent)
+            uint32_t grandparent = parents[parent].load(std::memory_order_acquire);
+            if (grandparent != parent) parents[item].compare_exchange_weak(parent, grandparent, std::memory_order_release, std::memory_order_relaxed);
+            item = grandparent;
+        }
+    }
+
+    /**
+     * @brief Merge the sets of two items.
+     * @param a The first item.
+     * @param b The second item.
+     * @return True if the sets were merged by this call, false if the items were already in the same set.
+     */
+    bool unite(uint32_t a, uint32_t b)
+    {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+
+            // Link the largest representative under the other one, unless it was linked by another thread since it was found
+            if (a > b) std::swap(a, b);
+            uint32_t expected = b;
+            if (parents[b].compare_exchange_strong(expected, a, std::memory_order_acq_rel, std::memory_order_relaxed)) return true;
+        }
+    }
+
+private:
+    /**
+     * @brief The parent of each item in the tree of its set (the representative is its own parent).
+     */
+    std::vector<std::atomic<uint32_t>> parents;
+};
+
+#endif // UNIONFIND_H